@@ -0,0 +1,151 @@
+#ifndef IDN16_BREAKPOINTS_H
+#define IDN16_BREAKPOINTS_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/*
+ * Breakpoints and watchpoints.
+ * PC breakpoints are one bit per instruction word, so checking the PC is a single bit test.
+ * A breakpoint may carry a condition, compiled once when it is set and only evaluated when
+ * its bit is hit. Watchpoints cover an address range; every WATCH_PAGE_SIZE page of memory
+ * has read/write flags, and only accesses to a flagged page look at the watchpoint list.
+ *
+ * breakpoints_check runs before an instruction, so a hit stops the CPU with the PC on the
+ * breakpoint or on the load/store about to touch a watched range. The run loop only calls it
+ * while breakpoints_active(), so running without any costs nothing.
+ * Watchpoints see guest loads and stores, not memory written by syscalls.
+ */
+
+#define BREAKPOINT_BYTES (MEMORY_SIZE / 2 / 8)
+#define MAX_CONDITIONS 64
+#define MAX_WATCHPOINTS 32
+
+#define WATCH_PAGE_SHIFT 8
+#define WATCH_PAGE_SIZE (1 << WATCH_PAGE_SHIFT)
+#define WATCH_PAGES (MEMORY_SIZE >> WATCH_PAGE_SHIFT)
+
+// Watchpoint kinds, also the page flags
+#define WATCH_READ 0x01
+#define WATCH_WRITE 0x02
+
+typedef enum {
+    COND_REGISTER,  // r[index]
+    COND_PC,
+    COND_FLAG,      // index 0-3: z, n, c, v
+    COND_MEMORY,    // The word at address
+} ConditionOperand_t;
+
+typedef enum {
+    COND_EQ, COND_NE, COND_LT, COND_LE, COND_GT, COND_GE,
+} ConditionOp_t;
+
+// A compiled "operand op value" condition; comparisons are unsigned
+typedef struct {
+    uint8_t operand;    // ConditionOperand_t
+    uint8_t index;
+    uint16_t address;
+    uint8_t op;         // ConditionOp_t
+    uint16_t value;
+} break_condition_t;
+
+typedef struct {
+    uint16_t start;
+    uint16_t end;       // Inclusive
+    uint8_t kind;       // WATCH_READ | WATCH_WRITE
+} watchpoint_t;
+
+typedef enum {
+    BREAK_NONE,
+    BREAK_PC,
+    BREAK_WATCH,
+} BreakReason_t;
+
+// Why breakpoints_check last stopped
+typedef struct {
+    BreakReason_t reason;
+    uint16_t pc;
+    uint16_t address;   // BREAK_WATCH: first byte accessed
+    bool write;
+} break_hit_t;
+
+/*
+ * Sets a breakpoint at address, replacing any there. condition may be NULL or a condition as
+ * accepted by breakpoint_compile. Returns false, setting nothing, if the condition is invalid
+ * or there are already MAX_CONDITIONS conditional breakpoints.
+ */
+bool breakpoint_set(uint16_t address, const char* condition);
+
+/*
+ * Removes the breakpoint at address. Returns false if there was none.
+ */
+bool breakpoint_clear(uint16_t address);
+
+/*
+ * Sets an unconditional breakpoint at address, or removes the one there.
+ * Returns true if a breakpoint is now set.
+ */
+bool breakpoint_toggle(uint16_t address);
+
+bool breakpoint_at(uint16_t address);
+
+/*
+ * Compiles "operand op value", where operand is r0-r7, sp, ra, pc, a flag (z, n, c, v) or
+ * [address] for the word at address; op is one of == != < <= > >=; address and value are
+ * numbers (0x for hex) or labels. A flag alone means "flag == 1".
+ */
+bool breakpoint_compile(const char* text, break_condition_t* condition);
+
+bool breakpoint_condition_holds(const break_condition_t* condition, const Cpu_t* cpu);
+
+/*
+ * Watches length bytes from start for the given kinds of access, replacing a watchpoint
+ * starting at the same address. Returns false if the range is empty or the list is full.
+ */
+bool watchpoint_set(uint16_t start, uint16_t length, uint8_t kind);
+
+/*
+ * Removes the watchpoint starting at start. Returns false if there was none.
+ */
+bool watchpoint_clear(uint16_t start);
+
+/*
+ * Removes all breakpoints and watchpoints.
+ */
+void breakpoints_clear_all(void);
+
+/*
+ * True while any breakpoint or watchpoint is set.
+ */
+bool breakpoints_active(void);
+
+/*
+ * Returns true if the instruction at cpu->pc hits a breakpoint or watchpoint and should not
+ * run; breakpoints_last_hit then says why.
+ */
+bool breakpoints_check(Cpu_t* cpu);
+
+const break_hit_t* breakpoints_last_hit(void);
+
+/*
+ * Prints the last hit, e.g. "Breakpoint at 0x0010 (loop+0)".
+ */
+void breakpoints_print_hit(FILE* out);
+
+/*
+ * Prints every breakpoint and watchpoint.
+ */
+void breakpoints_print(FILE* out);
+
+/*
+ * Runs a debugger command:
+ *     break <where> [if <condition>]
+ *     watch <where> [length] [r|w|rw]     (2 bytes, writes by default)
+ *     delete <where>
+ *     clear
+ *     list
+ * where is an address or a label. Errors are reported on stderr and return false.
+ */
+bool breakpoints_command(const char* command);
+
+#endif // IDN16_BREAKPOINTS_H
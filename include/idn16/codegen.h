@@ -3,6 +3,7 @@
 
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Emit a REG-format (register) instruction
 void emit_reg_format(uint16_t pc, uint8_t opcode, uint8_t rd, uint8_t rs1, uint8_t rs2, uint8_t func);
@@ -28,6 +29,9 @@ void emit_special_format_identifier(uint16_t pc, uint8_t opcode, uint8_t rd, uin
 // Emit an SP-format instruction with negative identifier to be resolved later
 void emit_special_format_neg_identifier(uint16_t pc, uint8_t opcode, uint8_t rd, uint8_t misc, const char* var_name, int line_num);
 
+// Emit a PUSHM (pop = 0) or POPM (pop = 1) instruction, regs has bit n set for each listed rn
+void emit_reglist_format(uint16_t pc, uint8_t pop, uint16_t regs, int line_num);
+
 // Emit LOAD16 macro with identifier
 void emit_load16_identifier(uint16_t pc, uint8_t rd, const char* var_name, int line_num);
 
@@ -38,6 +42,13 @@ void emit_push_pseudo(uint16_t pc, uint8_t reg);
 void emit_pop_pseudo(uint16_t pc, uint8_t reg);
 
 
+// Record that the words in [start_pc, end_pc) came from source line line_num
+void map_source_line(uint16_t start_pc, uint16_t end_pc, int line_num);
+
+// Write "ADDR LINE" lines for every word with a known source line, after a "source <path>" line.
+// Returns false if the file cannot be written.
+bool write_line_map(const char* filename, const char* source);
+
 // After all emits, resolve identifiers and write out the final binary
 void finalize_output(const char* filename);
 
@@ -0,0 +1,70 @@
+#ifndef IDN16_COVERAGE_H
+#define IDN16_COVERAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * Guest code coverage.
+ * One bit per instruction word records whether it ran, and two more record whether a branch
+ * there was taken and not taken. While coverage is enabled the emulator runs cpu_cycle_covered
+ * instead of cpu_cycle, so it costs nothing otherwise.
+ *
+ * Coverage files start with COVERAGE_MAGIC and a version byte, followed by the executed, taken
+ * and not-taken bitmaps. Files merge by OR-ing the bitmaps, so the runs of a whole test fleet
+ * can be combined; idn16-cov merges them and maps them to source lines.
+ */
+
+#define COVERAGE_BYTES (MEMORY_SIZE / 2 / 8)
+
+#define COVERAGE_MAGIC "IDN16COV"
+#define COVERAGE_MAGIC_LENGTH 8
+#define COVERAGE_VERSION 1
+
+typedef struct {
+    uint8_t executed[COVERAGE_BYTES];   // Bit (pc / 2) set once the word at pc ran
+    uint8_t taken[COVERAGE_BYTES];      // Branches that jumped
+    uint8_t not_taken[COVERAGE_BYTES];  // Branches that fell through
+} coverage_t;
+
+void coverage_enable(bool enabled);
+bool coverage_enabled(void);
+
+/*
+ * Clears the bitmaps of the current run.
+ */
+void coverage_reset(void);
+
+/*
+ * Records that the instruction at pc ran and continued at next_pc.
+ */
+void coverage_record(uint16_t pc, uint16_t instruction, uint16_t next_pc);
+
+/*
+ * The current run's bitmaps.
+ */
+coverage_t* coverage_data(void);
+
+/*
+ * Tests a bit of one of the bitmaps for the word at address.
+ */
+bool coverage_test(const uint8_t* bitmap, uint16_t address);
+
+/*
+ * ORs from into into.
+ */
+void coverage_merge(coverage_t* into, const coverage_t* from);
+
+/*
+ * Writes coverage to path. Returns false if it cannot be written.
+ */
+bool coverage_save(const coverage_t* coverage, const char* path);
+
+/*
+ * Reads a coverage file and ORs it into coverage.
+ * Returns false, leaving coverage untouched, if the file cannot be read or is not a coverage file.
+ */
+bool coverage_load_merge(coverage_t* coverage, const char* path);
+
+#endif // IDN16_COVERAGE_H
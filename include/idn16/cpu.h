@@ -1,11 +1,16 @@
 #ifndef IDN16_CPU_H
 #define IDN16_CPU_H
 
+// Default clock and refresh rates; the emulator can change both at runtime (see timing.h)
 #define CPU_CLOCK_HZ 1000000 // 1 MHz
 #define DISPLAY_REFRESH_HZ 240 // 240 Hz
 #define CYCLES_PER_FRAME (CPU_CLOCK_HZ / DISPLAY_REFRESH_HZ)
 #define MS_PER_FRAME (int)(1000 / DISPLAY_REFRESH_HZ)
 
+// Cycle cost of the block memory syscalls: a fixed call overhead plus a per-byte rate
+#define BLOCK_SYSCALL_BASE_CYCLES 8
+#define BLOCK_SYSCALL_BYTES_PER_CYCLE 2
+
 #include "memory.h"
 
 typedef struct {
@@ -30,9 +35,12 @@ typedef struct {
         uint8_t reserved : 4; // For future use
     } flags;
 
-    // Cycle counter for CPU timing
+    // Cycle counter for CPU timing: one per instruction, plus whatever syscalls charge
     uint64_t cycles;
 
+    // Instructions executed
+    uint64_t instructions;
+
     // Frame counter for display timing
     uint32_t frame_count;
 
@@ -75,6 +83,16 @@ void cpu_destroy(Cpu_t* cpu);
  */
 void cpu_cycle(Cpu_t* cpu);
 
+/*
+ * Runs cpu_cycle and records the instruction in the coverage bitmaps (see coverage.h).
+ */
+void cpu_cycle_covered(Cpu_t* cpu);
+
+/*
+ * Stops the CPU, reporting reason and the PC, and dumps the last executed instructions.
+ */
+void cpu_fault(Cpu_t* cpu, const char* reason);
+
 /*
  * Returns the current instruction according to the
  * cpu's program counter.
@@ -94,7 +112,14 @@ shared decode(uint16_t instruction);
 void execute(shared info, Cpu_t* cpu);
 
 /*
- * System call handler
+ * Works out the data memory a decoded load or store is about to access, from the registers
+ * before it runs. Returns false for instructions that do not access data memory.
+ */
+bool cpu_data_access(const shared* i, const Cpu_t* cpu, uint16_t* address, uint16_t* length, bool* write);
+
+/*
+ * System call handler.
+ * Dispatches through the table in syscall_table.c; unknown addresses are reported on stderr.
  */
 void handle_system_call(uint16_t address, Cpu_t* cpu);
 
@@ -142,5 +167,13 @@ void syscall_timer_stop(Cpu_t* cpu);
 void syscall_timer_query(Cpu_t* cpu);
 void syscall_sleep(Cpu_t* cpu);
 void syscall_number_to_string(Cpu_t* cpu);
+void syscall_update_sprites(Cpu_t* cpu);
+void syscall_load_tiles(Cpu_t* cpu);
+void syscall_load_palette(Cpu_t* cpu);
+void syscall_collide_sprites(Cpu_t* cpu);
+void syscall_memset(Cpu_t* cpu);
+void syscall_memcmp(Cpu_t* cpu);
+void syscall_memchr(Cpu_t* cpu);
+void syscall_strlen(Cpu_t* cpu);
 
 #endif // IDN16_CPU_H
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef IDN16_CPU_STEP_H
+#define IDN16_CPU_STEP_H
+
+#include <string.h>
+#include "cpu.h"
+#include "trace.h"
+
+/*
+ * One interpreter step, shared by cpu_cycle, cpu_cycle_covered and cpu_cycle_profiled so the
+ * bookkeeping every instruction needs lives in one place.
+ * cpu_step_begin fetches and decodes the instruction at the PC; it returns false, with the CPU
+ * stopped, if the PC is out of bounds. The caller may look at the decoded step before
+ * cpu_step_end executes it and updates the cycle and instruction counts and the trace.
+ */
+
+typedef struct {
+    uint16_t pc;
+    uint16_t inst;
+    shared i;
+    uint16_t before[8];     // Registers before the instruction, for the trace
+} cpu_step_t;
+
+static inline bool cpu_step_begin(Cpu_t* cpu, cpu_step_t* step) {
+    if (cpu->pc > RAM_END) {
+        cpu_fault(cpu, "Program counter out of bounds");
+        return false;
+    }
+    step->pc = cpu->pc;
+    memcpy(step->before, cpu->r, sizeof(step->before));
+    step->inst = fetch(cpu);
+    step->i = decode(step->inst);
+    return true;
+}
+
+static inline void cpu_step_end(Cpu_t* cpu, const cpu_step_t* step) {
+    execute(step->i, cpu);
+    cpu->cycles++;
+    cpu->instructions++;
+    trace_record(cpu, step->pc, step->inst, step->before);
+}
+
+#endif // IDN16_CPU_STEP_H
@@ -42,6 +42,25 @@
 #define LDB  30
 #define STB  31
 
+// SP-format arithmetic (REG-format operands)
+#define MUL  32
+#define MULH 33
+#define DIV  34
+#define MOD  35
+#define ADC  36
+#define SBC  37
+
+// SP-format post-increment memory access and register lists
+#define LDBP  38
+#define STBP  39
+#define LDWP  40
+#define STWP  41
+#define PUSHM 42
+#define POPM  43
+
+// Register list bits of PUSHM/POPM: r1..r5 and ra (r0 and sp cannot be listed)
+#define REGLIST_BITS 6
+
 void add(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
 void sub(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
 void and(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
@@ -75,5 +94,17 @@ void dec(uint16_t rd, Cpu_t *cpu);
 void lui(uint16_t rd, uint16_t imm, Cpu_t *cpu);
 void stb(uint16_t rd, uint16_t rs1, uint8_t imm, Cpu_t *cpu);
 void ldb(uint16_t rd, uint16_t rs1, uint8_t imm, Cpu_t *cpu);
+void mul(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void mulh(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void divu(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void modu(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void adc(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void sbc(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu);
+void ldb_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu);
+void stb_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu);
+void ldw_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu);
+void stw_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu);
+void pushm(uint16_t reglist, Cpu_t *cpu);
+void popm(uint16_t reglist, Cpu_t *cpu);
 
 #endif // IDN16_INSTRUCTIONS_H
\ No newline at end of file
@@ -33,6 +33,11 @@ void audio_destroy(void);
  */
 void audio_update(uint8_t *memory);
 
+/*
+ * Bytes of audio queued for the device and not played yet
+ */
+uint32_t audio_queued_bytes(void);
+
 /*
  * Enable or disable audio globally
  */
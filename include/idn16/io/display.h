@@ -5,6 +5,26 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include "idn16/memory.h"
+#include "idn16/video.h"
+
+// Printable glyphs cached from the 8x8 font (' ' through '~')
+#define GLYPH_FIRST 32
+#define GLYPH_LAST 126
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+#define DISPLAY_VRAM_SIZE (VIDEO_RAM_END - VIDEO_RAM_START + 1)
+
+// Immutable copy of video memory and video state, taken at a frame boundary
+typedef struct {
+    uint8_t vram[DISPLAY_VRAM_SIZE];
+    video_snapshot_t video;
+
+    // Background layer; the tilemap lives outside video RAM so it is copied separately
+    bool bg_enabled;
+    video_background_t bg;
+    uint8_t bg_map[BG_MAP_MAX_SIZE * BG_MAP_MAX_SIZE];
+} display_frame_t;
 
 typedef struct  {
     int width;
@@ -13,15 +33,53 @@ typedef struct  {
     SDL_Renderer* renderer;
     SDL_Texture* texture;
     uint8_t* memory;
-    uint16_t* pixels;
+    bool true_color;            // Output XRGB8888 so the texture upload needs no conversion
+    int bytes_per_pixel;
+
+    // Double-buffered output, RGB565 or XRGB8888 (see true_color).
+    // The render thread draws into one buffer while the other holds the last finished frame.
+    void* framebuffers[2];
+    int ready_buffer;           // Last finished framebuffer, -1 before the first frame
+    bool ready_uploaded;        // ready_buffer is already in the texture
+
+    // Frame snapshots handed to the render thread, guarded by render_lock
+    display_frame_t frames[2];
+    int pending_frame;          // Snapshot waiting to be rasterised, -1 if none
+    int rendering_frame;        // Snapshot being rasterised, -1 if none
+    uint32_t frames_dropped;    // Snapshots replaced before the render thread got to them
+
+    SDL_Thread* render_thread;
+    SDL_Mutex* render_lock;
+    SDL_Condition* render_cond;
+    bool render_quit;
+
+    // Render thread only: the snapshot and buffer of the frame being rasterised
+    const display_frame_t* frame;
+    void* pixels;
     
     // TTF font for text rendering
     TTF_Font* font;
     int char_width;
     int char_height;
     
+    // Pre-expanded RGB565/XRGB8888 tiles, rebuilt when the tile or the palette changes
+    uint16_t tile_cache[MAX_TILES][TILE_SIZE * TILE_SIZE];
+    uint32_t tile_cache32[MAX_TILES][TILE_SIZE * TILE_SIZE];
+    uint32_t tile_cache_generation[MAX_TILES];
+    uint32_t tile_cache_palette_generation;
+
+    // Pre-expanded RGB565/XRGB8888 glyphs for the current fg/bg colour pair
+    uint16_t glyph_cache[GLYPH_COUNT][TILE_SIZE * TILE_SIZE];
+    uint32_t glyph_cache32[GLYPH_COUNT][TILE_SIZE * TILE_SIZE];
+    uint16_t glyph_cache_fg;
+    uint16_t glyph_cache_bg;
+    bool glyph_cache_valid;
+
     // Performance stats
     uint32_t frames_rendered;
+    uint64_t raster_ns;         // Snapshot and raster time since display_take_counters, guarded by render_lock
+    uint32_t dirty_cells;       // Character cells changed since display_take_counters
+    uint8_t last_chars[CHAR_BUFFER_END - CHAR_BUFFER_START + 1];    // Character buffer of the last submitted frame
 } display_t;
 
 /*
@@ -36,15 +94,54 @@ display_t* display_init(int width, int height, int scale, uint8_t memory[], SDL_
 void display_destroy(display_t *display);
 
 /*
- * Updates the screen with the newest pixel information.
+ * Switches the output between RGB565 and XRGB8888 (true color).
+ * Recreates the texture and pixel buffer; returns false if that fails.
+ */
+bool display_set_true_color(display_t *display, bool true_color);
+
+/*
+ * Snapshots video memory at a frame boundary and hands it to the render thread.
+ * If the previous snapshot has not been picked up yet it is replaced (the frame is dropped).
+ */
+void display_submit_frame(display_t *display);
+
+/*
+ * Uploads the most recently rasterised frame to the texture.
+ * Must be called from the thread that owns the renderer; never waits for the render thread.
  */
 void display_update(display_t *display, SDL_FRect *where);
 
 /*
- * Text rendering functions
+ * Hands out the host time spent snapshotting and rasterising frames and the number of
+ * character cells that changed between submitted frames since the last call, and starts
+ * counting again.
+ */
+void display_take_counters(display_t *display, uint64_t *raster_ns, uint32_t *dirty_cells);
+
+/*
+ * True while a submitted frame is still being rasterised or has not been uploaded yet,
+ * so the caller knows another display_update would change the texture.
+ */
+bool display_frame_waiting(display_t *display);
+
+/*
+ * Rasterises frame into pixels (in the display's output format).
+ * The render thread calls this; it only touches the render thread's caches.
+ */
+void display_render_frame(display_t *display, const display_frame_t *frame, void *pixels);
+
+/*
+ * Text rendering functions.
+ * These and the sprite functions below draw display->frame into display->pixels.
  */
 void render_text(display_t* display);
 
+/*
+ * Background layer rendering.
+ * Draws the wrapping tilemap at its pixel scroll offset; cells with tile_id 0 are left empty.
+ */
+void render_background(display_t* display);
+
 /*
  * Sprite rendering functions
  */
@@ -52,6 +149,14 @@ void render_sprites(display_t* display);
 void render_sprite_to_buffer(display_t* display, uint8_t id, uint16_t x, uint16_t y);
 uint16_t get_palette_color(display_t* display, uint8_t palette_index);
 
+/*
+ * Tile cache functions.
+ * Return the expanded 8x8 RGB565 pixels, rebuilding the entry first if it is stale.
+ * The XRGB8888 copy in tile_cache32/glyph_cache32 is rebuilt at the same time.
+ */
+const uint16_t* get_cached_tile(display_t* display, uint8_t id);
+const uint16_t* get_cached_glyph(display_t* display, uint8_t ch, uint16_t fg_color, uint16_t bg_color);
+
 /*
  * Utility functions
  */
@@ -0,0 +1,53 @@
+#ifndef IDN16_LABELS_H
+#define IDN16_LABELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Guest code labels, loaded from the "ADDR NAME" symbol file the assembler writes next to
+ * each ROM (rom.bin.sym). Used to name addresses in profiles and traces.
+ */
+
+// Maximum number of labels loaded from a symbol file, and the longest name kept
+#define MAX_LABELS 4096
+#define LABEL_NAME_LENGTH 64
+
+/*
+ * Loads a symbol file, replacing any labels loaded before.
+ * Returns false, keeping the current labels, if the file cannot be opened.
+ */
+bool labels_load(const char* path);
+
+/*
+ * Forgets all labels, e.g. when the ROM they belong to is closed.
+ */
+void labels_clear(void);
+
+/*
+ * Number of loaded labels.
+ */
+int labels_count(void);
+
+/*
+ * Index of the last label at or before address in address order, or -1 if there is none.
+ */
+int labels_index(uint16_t address);
+
+/*
+ * Name of the label at index, as returned by labels_index.
+ */
+const char* labels_name(int index);
+
+/*
+ * Looks up a label by name. Returns false if there is no such label.
+ */
+bool labels_find(const char* name, uint16_t* address);
+
+/*
+ * Returns the label at or before address, or NULL if there is none.
+ * offset (may be NULL) receives the distance from the label.
+ */
+const char* labels_lookup(uint16_t address, uint16_t* offset);
+
+#endif // IDN16_LABELS_H
@@ -0,0 +1,36 @@
+#ifndef IDN16_LISTING_H
+#define IDN16_LISTING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * Cached disassembly listing of user ROM and RAM, one line per instruction word:
+ *     label            ADDR  WORD  instruction
+ * A line is formatted the first time it is asked for and kept together with the word it
+ * was formatted from. Asking again only compares that word with memory, so a line is
+ * formatted again only after its word is written with a new value. Showing a window of
+ * the listing therefore costs the same however large the program is.
+ */
+
+#define LISTING_WORDS ((RAM_END + 1) / 2)
+#define LISTING_LINE_LENGTH 80
+
+/*
+ * The listing line for the word at address (rounded down to a word), without a newline.
+ * The text stays valid until the line is formatted again.
+ */
+const char* listing_line(const uint8_t memory[], uint16_t address);
+
+/*
+ * Drops every cached line, e.g. after loading labels.
+ */
+void listing_invalidate_all(void);
+
+/*
+ * Number of lines formatted since the start, for checking the cache.
+ */
+uint32_t listing_format_count(void);
+
+#endif // IDN16_LISTING_H
@@ -11,6 +11,11 @@
 // Memory region sizes
 #define MEMORY_SIZE 65536 // 64KB
 
+// Pages for write tracking
+#define MEMORY_PAGE_SHIFT 8
+#define MEMORY_PAGE_SIZE (1 << MEMORY_PAGE_SHIFT)
+#define MEMORY_PAGES (MEMORY_SIZE >> MEMORY_PAGE_SHIFT)
+
 // Memory Map addressing constraints
 #define USER_ROM_START 0x0000
 #define USER_ROM_END 0x7FFF               // 32KB user program ROM
@@ -58,6 +63,19 @@
 // Video Control Register Offsets
 #define CURSOR_X_REG (VIDEO_CONTROL_START)        // Text cursor X
 #define CURSOR_Y_REG (VIDEO_CONTROL_START + 2)    // Text cursor Y
+#define TEXT_SCROLL_X_REG (VIDEO_CONTROL_START + 4)  // Text layer scroll X (columns, wraps at 40)
+#define TEXT_SCROLL_Y_REG (VIDEO_CONTROL_START + 6)  // Text layer scroll Y (rows, wraps at 30)
+#define TEXT_FG_COLOR_REG (VIDEO_CONTROL_START + 10) // Text foreground color (RGB565)
+#define TEXT_BG_COLOR_REG (VIDEO_CONTROL_START + 12) // Text background color (RGB565)
+#define BG_CONTROL_REG (VIDEO_CONTROL_START + 14)    // Background layer control, see BG_ENABLE
+#define BG_MAP_ADDR_REG (VIDEO_CONTROL_START + 16)   // Background tilemap address (one tile_id byte per cell, row-major)
+#define BG_MAP_WIDTH_REG (VIDEO_CONTROL_START + 18)  // Tilemap width in tiles (1-64)
+#define BG_MAP_HEIGHT_REG (VIDEO_CONTROL_START + 20) // Tilemap height in tiles (1-64)
+#define BG_SCROLL_X_REG (VIDEO_CONTROL_START + 22)   // Background scroll X in pixels (wraps)
+#define BG_SCROLL_Y_REG (VIDEO_CONTROL_START + 24)   // Background scroll Y in pixels (wraps)
+
+#define BG_ENABLE 0x0001                             // BG_CONTROL_REG bit 0 turns the layer on
+#define BG_MAP_MAX_SIZE 64                           // Largest tilemap width/height in tiles
 
 // Input Register Offsets
 #define INPUT_CONTROLLER1 (INPUT_REG_START + 0)
@@ -131,10 +149,31 @@ uint16_t memory_read_word(uint8_t memory[], uint16_t address);
 bool memory_write_byte(uint8_t memory[], uint16_t address, uint8_t data, bool privileged);
 bool memory_write_word(uint8_t memory[], uint16_t address, uint16_t data, bool privileged);
 
+/*
+ * Writes length bytes from data starting at address, with a single privilege check for the
+ * whole range. Video state is refreshed once for the range instead of once per byte.
+ * Fails without writing anything if the range runs past the end of memory.
+ * data may point into memory itself, even overlapping the destination.
+ */
+bool memory_write_block(uint8_t memory[], uint16_t address, const uint8_t* data, uint16_t length, bool privileged);
+
+/*
+ * Sets length bytes starting at address to value, with the same checks as memory_write_block.
+ */
+bool memory_fill_block(uint8_t memory[], uint16_t address, uint8_t value, uint16_t length, bool privileged);
+
+/*
+ * Write tracking: every write through the functions above, and loading a ROM, marks the
+ * MEMORY_PAGE_SIZE pages it touches dirty until memory_clear_dirty_pages.
+ */
+bool memory_page_dirty(uint8_t page);
+void memory_clear_dirty_pages(void);
+
 /* 
  * Memory region management
  */
 MemoryRegion_t memory_get_region(uint16_t address);
+const char* memory_region_name(MemoryRegion_t region);
 void memory_dump(uint8_t memory[], uint16_t start_addr, uint16_t bytes_per_line, uint16_t num_lines);
 
 /* 
@@ -188,5 +227,16 @@ void initialize_audio_system(uint8_t memory[]);
 #define SYSCALL_STOP_CHANNEL        0xF325
 #define SYSCALL_SET_MASTER_VOLUME   0xF326
 #define SYSCALL_STOP_ALL_AUDIO      0xF327
+#define SYSCALL_UPDATE_SPRITES      0xF328
+#define SYSCALL_LOAD_TILES          0xF329
+#define SYSCALL_LOAD_PALETTE        0xF32A
+#define SYSCALL_COLLIDE_SPRITES     0xF32B
+#define SYSCALL_MEMSET              0xF32C
+#define SYSCALL_MEMCMP              0xF32D
+#define SYSCALL_MEMCHR              0xF32E
+#define SYSCALL_STRLEN              0xF32F
+
+// SYSCALL_UPDATE_SPRITES record: 16-bit sprite id, x, y, tile_id
+#define SPRITE_RECORD_SIZE 5
 
 #endif // IDN16_MEMORY_H
\ No newline at end of file
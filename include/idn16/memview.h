@@ -0,0 +1,36 @@
+#ifndef IDN16_MEMVIEW_H
+#define IDN16_MEMVIEW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * Change tracking for the live memory viewer.
+ * memview_update runs once per frame and only compares the pages memory.c marked dirty
+ * against a snapshot of the previous frame, so a frame without writes costs one pass over
+ * MEMORY_PAGES flags. Bytes stay highlighted for MEMVIEW_HIGHLIGHT_FRAMES updates so a
+ * single change is visible at the display refresh rate.
+ */
+
+#define MEMVIEW_BYTES_PER_ROW 16
+#define MEMVIEW_ROWS (MEMORY_SIZE / MEMVIEW_BYTES_PER_ROW)
+#define MEMVIEW_HIGHLIGHT_FRAMES 30
+
+/*
+ * Takes a fresh snapshot of memory with nothing highlighted.
+ */
+void memview_reset(const uint8_t memory[]);
+
+/*
+ * Compares the dirty pages with the snapshot, records the bytes that changed, and clears
+ * the dirty flags. Returns the number of bytes that changed.
+ */
+int memview_update(const uint8_t memory[]);
+
+/*
+ * True if the byte at address changed in one of the last MEMVIEW_HIGHLIGHT_FRAMES updates.
+ */
+bool memview_changed(uint16_t address);
+
+#endif // IDN16_MEMVIEW_H
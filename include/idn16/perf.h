@@ -0,0 +1,85 @@
+#ifndef IDN16_PERF_H
+#define IDN16_PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Per-frame performance counters.
+ * The main loop adds host time per phase and guest counts to the open frame as it goes, and
+ * perf_end_frame closes it after each emulation tick. Closed frames go into a ring of the last
+ * PERF_HISTORY, which the on-screen HUD reads, and to a CSV log when one is open, so the same
+ * numbers are available without the HUD. Counting is a few additions per frame and always on.
+ *
+ * Log files start with a header line naming the columns; times are in nanoseconds:
+ *     host_ns,cpu_ns,raster_ns,upload_ns,ui_ns,present_ns,guest_frames,instructions,syscalls,dirty_cells,audio_queued_bytes
+ */
+
+// Frames kept, a power of two
+#define PERF_HISTORY 256
+
+typedef enum {
+    PERF_CPU,       // Running guest frames
+    PERF_RASTER,    // Snapshotting video memory and rasterising it (render thread)
+    PERF_UPLOAD,    // Uploading the finished frame to the texture
+    PERF_UI,        // Clay layout and drawing its render commands
+    PERF_PRESENT,   // SDL_RenderPresent
+    PERF_PHASES
+} PerfPhase_t;
+
+typedef struct {
+    uint64_t host_ns;                   // Wall time since the previous frame closed
+    uint64_t phase_ns[PERF_PHASES];
+    uint32_t guest_frames;              // More than one when frames were skipped
+    uint64_t instructions;
+    uint32_t syscalls;
+    uint32_t dirty_cells;               // Character cells that changed on screen
+    uint32_t audio_queued_bytes;        // Audio waiting to be played when the frame closed
+} perf_frame_t;
+
+/*
+ * The frame being counted. Counters are added to it directly.
+ */
+perf_frame_t* perf_current(void);
+
+void perf_add_time(PerfPhase_t phase, uint64_t ns);
+
+/*
+ * Closes the current frame, adds it to the history and the log, and opens the next one.
+ */
+void perf_end_frame(uint64_t now_ns);
+
+/*
+ * Drops the current frame and starts the next one at now_ns, e.g. when resuming after a
+ * pause, so the pause does not show up as one long frame.
+ */
+void perf_restart(uint64_t now_ns);
+
+/*
+ * Empties the history.
+ */
+void perf_clear(void);
+
+/*
+ * Copies up to max of the newest frames into out, oldest first. Returns the number copied.
+ */
+int perf_last(perf_frame_t* out, int max);
+
+/*
+ * Adds up the newest count frames into sum. Returns the number of frames added.
+ */
+int perf_sum(int count, perf_frame_t* sum);
+
+const char* perf_phase_name(PerfPhase_t phase);
+
+/*
+ * Writes every frame closed from now on to path as CSV. Returns false if it cannot be created.
+ */
+bool perf_log_open(const char* path);
+void perf_log_close(void);
+
+void perf_write_header(FILE* out);
+void perf_write_frame(FILE* out, const perf_frame_t* frame);
+
+#endif // IDN16_PERF_H
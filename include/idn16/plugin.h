@@ -0,0 +1,32 @@
+#ifndef IDN16_PLUGIN_H
+#define IDN16_PLUGIN_H
+
+#include "plugin_api.h"
+
+/*
+ * Host side of the native syscall plugin interface (see plugin_api.h).
+ */
+
+// Maximum number of loaded plugins and of syscalls all plugins may register together
+#define MAX_PLUGINS 16
+#define MAX_PLUGIN_SYSCALLS 256
+
+/*
+ * Loads the shared library at path and runs its init function.
+ * Returns false, with the reason on stderr, if the library cannot be loaded,
+ * has no init function or its init function fails. A failed plugin's syscalls are removed.
+ */
+bool plugin_load(const char* path);
+
+/*
+ * Runs every plugin's shutdown function, removes their syscalls and unloads them.
+ */
+void plugin_unload_all(void);
+
+/*
+ * Function table handed to plugins. Also lets the emulator register host-side handlers
+ * through the same checked interface without loading a library.
+ */
+const idn16_host_api_t* plugin_host_api(void);
+
+#endif // IDN16_PLUGIN_H
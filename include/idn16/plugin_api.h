@@ -0,0 +1,68 @@
+#ifndef IDN16_PLUGIN_API_H
+#define IDN16_PLUGIN_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Native syscall plugins.
+ * A plugin is a shared library loaded with --plugin <path>. It exports
+ *
+ *     bool idn16_plugin_init(const idn16_host_api_t* host);
+ *
+ * and registers its handlers from there with host->register_syscall. Guest code calls a
+ * handler like any other syscall: JSR to its address. An optional
+ *
+ *     void idn16_plugin_shutdown(void);
+ *
+ * runs before the library is unloaded.
+ *
+ * Handlers never see the emulator's CPU struct. They get an opaque handle and go through
+ * the host functions, which keep r0 at zero and apply the same range and privilege checks
+ * as guest stores, so a plugin cannot write ROM or memory outside the 64 KiB address space.
+ * This header only depends on the C standard library, so plugins can be built on their own.
+ */
+
+#define IDN16_PLUGIN_API_VERSION 1
+
+// Exported entry points
+#define IDN16_PLUGIN_INIT_SYMBOL "idn16_plugin_init"
+#define IDN16_PLUGIN_SHUTDOWN_SYMBOL "idn16_plugin_shutdown"
+
+typedef struct idn16_cpu idn16_cpu_t;
+
+typedef void (*idn16_syscall_fn)(idn16_cpu_t* cpu, void* userdata);
+
+typedef struct {
+    uint32_t api_version;  // IDN16_PLUGIN_API_VERSION of the host
+
+    // Registers r0-r7; writes to r0 and reads/writes of other indices are ignored (reads give 0)
+    uint16_t (*get_reg)(idn16_cpu_t* cpu, int reg);
+    void (*set_reg)(idn16_cpu_t* cpu, int reg, uint16_t value);
+
+    // Guest memory. Words are stored in the emulator's host byte order, so access them
+    // through read_word/write_word rather than assembling bytes
+    uint8_t (*read_byte)(idn16_cpu_t* cpu, uint16_t address);
+    uint16_t (*read_word)(idn16_cpu_t* cpu, uint16_t address);
+    bool (*write_byte)(idn16_cpu_t* cpu, uint16_t address, uint8_t value);
+    bool (*write_word)(idn16_cpu_t* cpu, uint16_t address, uint16_t value);
+
+    // Block copies of raw bytes between guest memory and plugin buffers; false (and nothing
+    // copied) if any byte is out of range or, for writes, not writable by the guest
+    bool (*read_block)(idn16_cpu_t* cpu, uint16_t address, void* dest, uint16_t length);
+    bool (*write_block)(idn16_cpu_t* cpu, uint16_t address, const void* src, uint16_t length);
+
+    // Charges extra guest cycles on top of the handler's declared cost, e.g. per element
+    void (*charge_cycles)(idn16_cpu_t* cpu, uint32_t cycles);
+
+    // Installs handler at an unused address in 0xF300-0xFFFF. cycles is the guest cost of
+    // one call and argc the number of argument registers (from r1) it reads.
+    // name must stay valid while the plugin is loaded. Returns false if the address is taken.
+    bool (*register_syscall)(uint16_t address, const char* name, uint8_t argc, uint16_t cycles,
+                             idn16_syscall_fn handler, void* userdata);
+} idn16_host_api_t;
+
+typedef bool (*idn16_plugin_init_fn)(const idn16_host_api_t* host);
+typedef void (*idn16_plugin_shutdown_fn)(void);
+
+#endif // IDN16_PLUGIN_API_H
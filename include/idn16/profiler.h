@@ -0,0 +1,100 @@
+#ifndef IDN16_PROFILER_H
+#define IDN16_PROFILER_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/*
+ * Guest code profiler.
+ * Counts executions and cycles for every PC, the instruction mix and data traffic per memory
+ * region. Profiling runs through cpu_cycle_profiled, a separate interpreter step; the emulator
+ * only calls it while the profiler is enabled, so cpu_cycle pays nothing for it otherwise.
+ *
+ * The profiler also keeps a shadow call stack: JSR pushes a frame and RET pops back to the
+ * frame whose return address it jumps to, whether ra was kept in r7 or saved with PUSH ra.
+ * Cycles are attributed to a call tree with one node per call path; syscalls are leaves.
+ */
+
+// One counter slot per instruction word in the address space
+#define PROFILE_SLOTS (MEMORY_SIZE / 2)
+
+// Call tree size and shadow stack depth; deeper calls are charged to the deepest frame
+#define MAX_CALL_NODES 16384
+#define MAX_CALL_DEPTH 256
+
+// Rows per table in the emulator's reports
+#define PROFILE_REPORT_ROWS 20
+
+// Instruction classes of the mix report
+typedef enum {
+    INSN_CLASS_ALU,
+    INSN_CLASS_MULDIV,
+    INSN_CLASS_LOAD,
+    INSN_CLASS_STORE,
+    INSN_CLASS_BRANCH,
+    INSN_CLASS_CALL,
+    INSN_CLASS_SYSCALL,
+    INSN_CLASS_OTHER,
+    INSN_CLASS_COUNT
+} InsnClass_t;
+
+typedef struct {
+    uint64_t instructions;
+    uint64_t cycles;
+    uint64_t pc_count[PROFILE_SLOTS];      // Executions per PC, indexed by pc / 2
+    uint64_t pc_cycles[PROFILE_SLOTS];     // Cycles per PC, including syscall charges
+    uint64_t class_count[INSN_CLASS_COUNT];
+    uint64_t region_reads[REGION_COUNT];   // Data accesses by loads and POPM
+    uint64_t region_writes[REGION_COUNT];  // Data accesses by stores and PUSHM
+} profile_t;
+
+// One call path in the call tree. Node 0 is the code outside any call.
+typedef struct {
+    uint16_t address;     // Call target
+    bool syscall;         // Leaf for a JSR into the syscall range
+    int parent;           // -1 for the root
+    int first_child;      // -1 if none
+    int next_sibling;     // -1 if none
+    uint64_t calls;
+    uint64_t exclusive;   // Cycles spent in the target itself
+    uint64_t inclusive;   // Exclusive plus all callees, filled in by profiler_update_inclusive
+} call_node_t;
+
+void profiler_enable(bool enabled);
+bool profiler_enabled(void);
+
+/*
+ * Clears all counters. Loaded labels are kept.
+ */
+void profiler_reset(void);
+
+/*
+ * Runs one instruction like cpu_cycle and records it, and its coverage while coverage is enabled.
+ */
+void cpu_cycle_profiled(Cpu_t* cpu);
+
+const profile_t* profiler_data(void);
+
+/*
+ * Returns the call tree and its node count in count.
+ */
+const call_node_t* profiler_call_tree(int* count);
+
+/*
+ * Sums the exclusive cycles of each call tree node's subtree into its inclusive cycles.
+ */
+void profiler_update_inclusive(void);
+
+/*
+ * Writes the call tree in collapsed-stack format, one "frame;frame;frame cycles" line per
+ * call path with exclusive cycles, for flame graph tools. Returns false if the file cannot be written.
+ */
+bool profiler_write_collapsed(const char* path);
+
+/*
+ * Prints the instruction mix, memory traffic, the max_rows hottest PCs, cycles per label
+ * when labels are loaded (see labels.h), inclusive and exclusive cycles per call target, and the syscall counters.
+ */
+void profiler_print_report(FILE* out, const Cpu_t* cpu, int max_rows);
+
+#endif // IDN16_PROFILER_H
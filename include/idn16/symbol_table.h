@@ -2,6 +2,7 @@
 #define SYMBOL_TABLE_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #define MAX_SYMBOL 8192
 
 typedef struct Symbol {
@@ -19,6 +20,9 @@ void sort_symbols(void);
 // Look up a previously inserted label/assignment and returns its value and type; exits on undefined label/assignment
 int get_symbol(const char* name, int* type);
 
+// Write the labels as "ADDR NAME" lines in address order, for the emulator's profiler; false if the file cannot be written
+bool write_symbol_file(const char* filename);
+
 // Free all label storage (call at end of assembly)
 void free_symbols(void);
 
@@ -0,0 +1,78 @@
+#ifndef IDN16_SYSCALL_TABLE_H
+#define IDN16_SYSCALL_TABLE_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/*
+ * System call dispatch table.
+ * One entry per address from SYSCALL_BASE, indexed by address - SYSCALL_BASE.
+ * handle_system_call looks the entry up, charges its cycle cost and updates its counters.
+ */
+
+// One table slot per address in SYSCALL_BASE..SYSCALL_END
+#define SYSCALL_TABLE_SIZE (SYSCALL_END - SYSCALL_BASE + 1)
+
+// syscall_info_t flags
+#define SYSCALL_TOUCHES_VIDEO 0x01
+#define SYSCALL_TOUCHES_AUDIO 0x02
+
+typedef void (*syscall_handler_t)(Cpu_t* cpu);
+typedef void (*syscall_context_handler_t)(Cpu_t* cpu, void* context);
+
+typedef struct {
+    const char* name;           // Name without the SYSCALL_ prefix
+    syscall_handler_t handler;  // Built-in handler, NULL for registered and unassigned addresses
+    syscall_context_handler_t context_handler;  // Handler added with syscall_register
+    void* context;              // Passed to context_handler
+    uint8_t argc;               // Number of argument registers read, starting at r1
+    uint8_t flags;              // SYSCALL_TOUCHES_VIDEO / SYSCALL_TOUCHES_AUDIO
+    uint16_t cycles;            // Guest cycles charged per call, on top of the JSR
+} syscall_info_t;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t guest_cycles;      // Cycles charged by the table and by the handler itself
+    uint64_t host_ns;           // Host time spent in the handler
+} syscall_stats_t;
+
+/*
+ * Returns the table entry for address, or NULL if no syscall lives there.
+ */
+const syscall_info_t* syscall_info(uint16_t address);
+
+/*
+ * Installs a handler at an unused address in SYSCALL_BASE..SYSCALL_END.
+ * name must stay valid until the handler is unregistered.
+ * Returns false if the address is outside the syscall range or already taken.
+ */
+bool syscall_register(uint16_t address, const char* name, uint8_t argc, uint8_t flags, uint16_t cycles,
+                      syscall_context_handler_t handler, void* context);
+
+/*
+ * Removes a handler installed with syscall_register. Built-in syscalls cannot be removed.
+ */
+void syscall_unregister(uint16_t address);
+
+/*
+ * Returns the counters for address, or NULL if address is outside the table.
+ */
+const syscall_stats_t* syscall_stats(uint16_t address);
+
+/*
+ * Calls to any syscall since startup. Unlike the per-syscall counters it is never reset,
+ * so callers count the difference between two reads.
+ */
+uint64_t syscall_total_calls(void);
+
+/*
+ * Clears all call counters and timings.
+ */
+void syscall_stats_reset(void);
+
+/*
+ * Prints every syscall that was called since the last reset, most host time first.
+ */
+void syscall_stats_print(FILE* out);
+
+#endif // IDN16_SYSCALL_TABLE_H
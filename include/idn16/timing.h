@@ -0,0 +1,69 @@
+#ifndef IDN16_TIMING_H
+#define IDN16_TIMING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Emulation timing and frame pacing.
+ * The clock rate and refresh rate start at CPU_CLOCK_HZ and DISPLAY_REFRESH_HZ and can be
+ * changed at runtime; a guest frame is then clock / refresh cycles long.
+ *
+ * A pacer schedules ticks on an absolute grid: tick n is due at start + n * 1e9 / hz ns,
+ * computed exactly rather than by adding a rounded period, so neither a late wake-up nor
+ * rounding accumulates into drift. Times are host nanoseconds supplied by the caller.
+ */
+
+#define MIN_CLOCK_HZ 1000
+#define MAX_CLOCK_HZ 100000000
+#define MIN_REFRESH_HZ 1
+#define MAX_REFRESH_HZ 1000
+
+#define NS_PER_SECOND 1000000000ULL
+
+/*
+ * Sets the clock and refresh rates. Returns false, changing nothing, if either is out of
+ * range or the clock is slower than the refresh rate.
+ */
+bool timing_set(uint32_t clock_hz, uint32_t refresh_hz);
+
+uint32_t timing_clock_hz(void);
+uint32_t timing_refresh_hz(void);
+uint32_t timing_cycles_per_frame(void);
+
+/*
+ * Length of a guest frame in nanoseconds, rounded down.
+ */
+uint64_t timing_frame_ns(void);
+
+/*
+ * Parses a rate such as "250000", "1.5MHz", "500khz" or "60Hz". Returns false if text is not
+ * a positive rate, optionally followed by k or M and then Hz.
+ */
+bool timing_parse_hz(const char* text, uint32_t* hz);
+
+typedef struct {
+    uint32_t hz;
+    uint64_t start_ns;      // When tick 0 was due
+    uint64_t ticks;         // Ticks handed out since start_ns
+    uint32_t max_lag;       // Further behind than this many ticks, the grid restarts
+} pacer_t;
+
+/*
+ * Starts ticking hz times a second, with the first tick due at now_ns.
+ */
+void pacer_start(pacer_t* pacer, uint32_t hz, uint32_t max_lag, uint64_t now_ns);
+
+/*
+ * Returns how many ticks are due at now_ns and moves past them. More than max_lag ticks
+ * behind (a stall, a debugger stop) it restarts the grid at now_ns and returns 1 instead of
+ * a burst of catch-up ticks.
+ */
+uint32_t pacer_due(pacer_t* pacer, uint64_t now_ns);
+
+/*
+ * When the next tick is due.
+ */
+uint64_t pacer_next_ns(const pacer_t* pacer);
+
+#endif // IDN16_TIMING_H
@@ -0,0 +1,103 @@
+#ifndef IDN16_TRACE_H
+#define IDN16_TRACE_H
+
+#include <stdio.h>
+#include "cpu.h"
+
+/*
+ * Execution trace.
+ * cpu_cycle keeps the last TRACE_RING_SIZE instructions in a ring buffer: the PC, the
+ * instruction word, which registers changed and their new values, and the flags. When the
+ * CPU faults the newest TRACE_FAULT_RECORDS are printed to stderr.
+ * The full trace can also be streamed to a file, and idn16-trace decodes such files.
+ *
+ * Trace files start with TRACE_MAGIC and a version byte, followed by delta-encoded records:
+ *     tag      TRACE_TAG_PC / TRACE_TAG_FLAGS
+ *     pc       2 bytes, only with TRACE_TAG_PC; otherwise the previous pc + 2
+ *     word     2 bytes
+ *     changed  1 byte, bit n set if r[n] changed
+ *     flags    1 byte, only with TRACE_TAG_FLAGS; otherwise the previous flags
+ *     values   2 bytes per changed register, lowest register first
+ * Multi-byte fields are little endian.
+ */
+
+// Ring buffer size, a power of two, and the number of records dumped on a fault
+#define TRACE_RING_SIZE 4096
+#define TRACE_FAULT_RECORDS 32
+
+// New values kept per record, one for every register, so POPM restoring several registers
+// and sp can be replayed from the trace
+#define TRACE_VALUES 8
+
+#define TRACE_MAGIC "IDN16TRC"
+#define TRACE_MAGIC_LENGTH 8
+#define TRACE_VERSION 2
+
+#define TRACE_TAG_PC 0x01
+#define TRACE_TAG_FLAGS 0x02
+
+// Longest encoded record
+#define TRACE_RECORD_MAX_BYTES (1 + 2 + 2 + 1 + 1 + 2 * TRACE_VALUES)
+
+// Bits of trace_record_t.flags
+#define TRACE_FLAG_Z 0x01
+#define TRACE_FLAG_N 0x02
+#define TRACE_FLAG_C 0x04
+#define TRACE_FLAG_V 0x08
+
+typedef struct {
+    uint16_t pc;
+    uint16_t instruction;
+    uint8_t changed;                 // Bit n set if r[n] changed
+    uint8_t flags;                   // TRACE_FLAG_* after the instruction
+    uint16_t values[TRACE_VALUES];   // New values of the changed registers, lowest first
+} trace_record_t;
+
+/*
+ * Adds one executed instruction to the ring buffer, and to the stream if one is open.
+ * before holds the registers from before the instruction ran.
+ */
+void trace_record(const Cpu_t* cpu, uint16_t pc, uint16_t instruction, const uint16_t before[8]);
+
+/*
+ * Empties the ring buffer.
+ */
+void trace_clear(void);
+
+/*
+ * Copies up to max of the newest records into out, oldest first. Returns the number copied.
+ */
+int trace_last(trace_record_t* out, int max);
+
+/*
+ * Prints the newest count records, oldest first, one decoded line each.
+ */
+void trace_dump(FILE* out, int count);
+
+/*
+ * Starts writing every executed instruction to path. Returns false if it cannot be created.
+ */
+bool trace_stream_open(const char* path);
+
+/*
+ * Flushes and closes the stream, if one is open.
+ */
+void trace_stream_close(void);
+
+/*
+ * Encoding and decoding of trace file records. prev is the previous record of the file,
+ * all zero before the first one, and is updated with the record written or read.
+ */
+int trace_encode(const trace_record_t* record, trace_record_t* prev, uint8_t out[TRACE_RECORD_MAX_BYTES]);
+bool trace_write_header(FILE* file);
+bool trace_read_header(FILE* file);
+bool trace_read_record(FILE* file, trace_record_t* prev, trace_record_t* record);
+
+/*
+ * Formats a record as "pc  label+offset  instruction  register changes  flags", using the
+ * labels from labels.h when loaded. TRACE_LINE_LENGTH holds any record.
+ */
+#define TRACE_LINE_LENGTH 192
+void trace_format(const trace_record_t* record, char* out, size_t size);
+
+#endif // IDN16_TRACE_H
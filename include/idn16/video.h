@@ -0,0 +1,135 @@
+#ifndef IDN16_VIDEO_H
+#define IDN16_VIDEO_H
+
+#include "memory.h"
+
+/*
+ * Host-side state derived from video memory.
+ * The memory write functions report every write inside VIDEO_RAM_START..VIDEO_RAM_END
+ * here, so the renderer can keep caches without rescanning video memory each frame.
+ */
+
+// One bit per sprite table entry in the active sprite index
+#define VIDEO_SPRITE_WORDS ((MAX_SPRITES + 63) / 64)
+
+// Grid cell of a sprite that is disabled or off-screen
+#define VIDEO_NO_CELL 0xFFFF
+
+/*
+ * Copy of the derived video state taken at a frame boundary.
+ * A renderer running on another thread works from a snapshot, never from the live state.
+ */
+typedef struct {
+    uint32_t palette_generation;
+    uint32_t tile_generation[MAX_TILES];
+    uint16_t palette_rgb565[PALETTE_SIZE];
+    uint32_t palette_xrgb8888[PALETTE_SIZE];
+    uint16_t text_fg_color;
+    uint16_t text_bg_color;
+    uint64_t active_sprites[VIDEO_SPRITE_WORDS];
+} video_snapshot_t;
+
+/*
+ * Rebuilds all derived video state from the current contents of memory.
+ */
+void video_state_reset(uint8_t memory[]);
+
+/*
+ * Called after the byte at address (inside video memory) has been written.
+ */
+void video_state_on_write(uint8_t memory[], uint16_t address);
+
+/*
+ * Called after every byte in first..last (inside video memory) has been written.
+ * Each palette entry, sprite and tile in the range is refreshed once.
+ */
+void video_state_on_write_range(uint8_t memory[], uint16_t first, uint16_t last);
+
+/*
+ * Generation counters. A counter changes every time its backing memory is written,
+ * so anything built from that memory is stale once the counter moves on.
+ * tile_index is the tileset slot (tile_id - 1).
+ */
+uint32_t video_palette_generation(void);
+uint32_t video_tile_generation(uint8_t tile_index);
+
+/*
+ * Host-side palette lookup tables, refreshed only when palette RAM is written.
+ * Both tables hold the 16 palette entries, in RGB565 and in XRGB8888.
+ */
+const uint16_t* video_palette_rgb565(void);
+const uint32_t* video_palette_xrgb8888(void);
+
+/*
+ * Current text colors in RGB565, refreshed when the text color registers are written.
+ * When both registers are zero the defaults (white on black) are returned.
+ */
+void video_text_colors(uint16_t* fg_color, uint16_t* bg_color);
+
+/*
+ * Expands an RGB565 color to XRGB8888.
+ */
+uint32_t video_rgb565_to_xrgb8888(uint16_t color);
+
+/*
+ * Active sprite index.
+ * A sprite is active while its tile_id byte is non-zero. The index is kept up to date
+ * by sprite table writes from both syscalls and guest STB/STW instructions.
+ */
+bool video_sprite_active(uint16_t sprite_id);
+uint16_t video_active_sprite_count(void);
+
+/*
+ * Returns the first active sprite id >= from, or MAX_SPRITES when there is none.
+ * Walking the index with this visits sprites in table order.
+ */
+uint16_t video_next_active_sprite(uint16_t from);
+
+/*
+ * Sprite occupancy grid.
+ * Every active sprite with on-screen tile coordinates is listed in the 40x30 cell it
+ * covers (cell = y * SCREEN_WIDTH_TILES + x); the grid follows all sprite table writes.
+ * video_sprite_cell returns VIDEO_NO_CELL for sprites that are not in the grid.
+ * A cell is walked with video_first_sprite_in_cell/video_next_sprite_in_cell until
+ * MAX_SPRITES is returned; sprites in a cell are in no particular order.
+ */
+uint16_t video_sprite_cell(uint16_t sprite_id);
+uint16_t video_first_sprite_in_cell(uint16_t cell);
+uint16_t video_next_sprite_in_cell(uint16_t sprite_id);
+
+/*
+ * Copies the current derived video state into snapshot.
+ * The text colors in the snapshot already have the white-on-black default applied.
+ */
+void video_state_snapshot(video_snapshot_t* snapshot);
+
+/*
+ * Same as video_next_active_sprite, but walks the index stored in a snapshot.
+ */
+uint16_t video_snapshot_next_active_sprite(const video_snapshot_t* snapshot, uint16_t from);
+
+/*
+ * Background layer registers, as read at a frame boundary.
+ */
+typedef struct {
+    uint16_t map_address;
+    uint16_t map_width;         // In tiles
+    uint16_t map_height;
+    uint16_t scroll_x;          // In pixels, less than the map width in pixels
+    uint16_t scroll_y;
+} video_background_t;
+
+/*
+ * Reads the background registers. Returns false if the layer is off or its map cannot be
+ * drawn: a width or height of 0 or above BG_MAP_MAX_SIZE tiles, or a map running past the
+ * end of memory. The scroll offsets are reduced to within the map.
+ */
+bool video_background_read(uint8_t memory[], video_background_t* background);
+
+/*
+ * Map pixel shown at screen pixel position along one axis of a map map_tiles tiles long,
+ * scrolled by a reduced scroll offset; the map repeats in both directions.
+ */
+uint16_t video_background_wrap(int position, uint16_t scroll, uint16_t map_tiles);
+
+#endif // IDN16_VIDEO_H
@@ -0,0 +1,385 @@
+#include "idn16/breakpoints.h"
+#include "idn16/labels.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint16_t address;
+    break_condition_t condition;
+} conditional_t;
+
+static uint8_t pc_bits[BREAKPOINT_BYTES];
+static int breakpoint_count = 0;
+static conditional_t conditionals[MAX_CONDITIONS];
+static int conditional_count = 0;
+
+static watchpoint_t watchpoints[MAX_WATCHPOINTS];
+static int watchpoint_count = 0;
+static uint8_t watch_pages[WATCH_PAGES];
+
+static break_hit_t last_hit;
+
+static const char* flag_names = "zncv";
+static const char* op_names[] = { "==", "!=", "<", "<=", ">", ">=" };
+
+static bool test_bit(uint16_t address) {
+    uint16_t slot = address >> 1;
+    return (pc_bits[slot >> 3] >> (slot & 7)) & 1;
+}
+
+static int find_conditional(uint16_t address) {
+    for (int i = 0; i < conditional_count; i++) {
+        if (conditionals[i].address == address) return i;
+    }
+    return -1;
+}
+
+static void remove_conditional(uint16_t address) {
+    int index = find_conditional(address);
+    if (index >= 0) conditionals[index] = conditionals[--conditional_count];
+}
+
+// Reads a number (0x for hex) or a label
+static bool parse_value(const char* token, uint16_t* value) {
+    if (labels_find(token, value)) return true;
+    char* end;
+    unsigned long number = strtoul(token, &end, 0);
+    if (*token == '\0' || *end != '\0' || number > 0xFFFF) return false;
+    *value = (uint16_t)number;
+    return true;
+}
+
+static const char* skip_spaces(const char* text) {
+    while (isspace((unsigned char)*text)) text++;
+    return text;
+}
+
+// Copies the next word, up to a space or an operator character, into token
+static const char* next_token(const char* text, char* token, size_t size) {
+    text = skip_spaces(text);
+    size_t length = 0;
+    while (*text && !isspace((unsigned char)*text) && !strchr("=!<>", *text)) {
+        if (length + 1 < size) token[length++] = *text;
+        text++;
+    }
+    token[length] = '\0';
+    return text;
+}
+
+static bool parse_operand(const char* token, break_condition_t* condition) {
+    size_t length = strlen(token);
+    if (length >= 3 && token[0] == '[' && token[length - 1] == ']') {
+        char inner[LABEL_NAME_LENGTH];
+        if (length - 2 >= sizeof(inner)) return false;
+        memcpy(inner, token + 1, length - 2);
+        inner[length - 2] = '\0';
+        condition->operand = COND_MEMORY;
+        return parse_value(inner, &condition->address);
+    }
+    if (length == 2 && token[0] == 'r' && token[1] >= '0' && token[1] <= '7') {
+        condition->operand = COND_REGISTER;
+        condition->index = token[1] - '0';
+        return true;
+    }
+    if (strcmp(token, "sp") == 0 || strcmp(token, "ra") == 0) {
+        condition->operand = COND_REGISTER;
+        condition->index = token[0] == 's' ? 6 : 7;
+        return true;
+    }
+    if (strcmp(token, "pc") == 0) {
+        condition->operand = COND_PC;
+        return true;
+    }
+    const char* flag = length == 1 ? strchr(flag_names, token[0]) : NULL;
+    if (flag) {
+        condition->operand = COND_FLAG;
+        condition->index = flag - flag_names;
+        return true;
+    }
+    return false;
+}
+
+bool breakpoint_compile(const char* text, break_condition_t* condition) {
+    char token[LABEL_NAME_LENGTH + 2];
+    memset(condition, 0, sizeof(*condition));
+    text = next_token(text, token, sizeof(token));
+    if (!parse_operand(token, condition)) return false;
+
+    text = skip_spaces(text);
+    if (*text == '\0' && condition->operand == COND_FLAG) {
+        condition->op = COND_EQ;
+        condition->value = 1;
+        return true;
+    }
+
+    // Longest operator first so "<=" is not read as "<"
+    int op = -1;
+    for (int i = 0; i < 6; i++) {
+        size_t length = strlen(op_names[i]);
+        if (strncmp(text, op_names[i], length) == 0 && (op < 0 || length > strlen(op_names[op]))) op = i;
+    }
+    if (op < 0) return false;
+    condition->op = op;
+    text += strlen(op_names[op]);
+
+    text = next_token(text, token, sizeof(token));
+    return parse_value(token, &condition->value) && *skip_spaces(text) == '\0';
+}
+
+bool breakpoint_condition_holds(const break_condition_t* condition, const Cpu_t* cpu) {
+    uint16_t value;
+    switch (condition->operand) {
+        case COND_REGISTER: value = cpu->r[condition->index]; break;
+        case COND_PC: value = cpu->pc; break;
+        case COND_MEMORY: value = memory_read_word((uint8_t*)cpu->memory, condition->address); break;
+        default: {
+            const uint8_t flags[4] = { cpu->flags.z, cpu->flags.n, cpu->flags.c, cpu->flags.v };
+            value = flags[condition->index];
+            break;
+        }
+    }
+    switch (condition->op) {
+        case COND_EQ: return value == condition->value;
+        case COND_NE: return value != condition->value;
+        case COND_LT: return value < condition->value;
+        case COND_LE: return value <= condition->value;
+        case COND_GT: return value > condition->value;
+        default: return value >= condition->value;
+    }
+}
+
+bool breakpoint_set(uint16_t address, const char* condition) {
+    address &= ~1;
+    break_condition_t compiled;
+    if (condition) {
+        if (!breakpoint_compile(condition, &compiled)) {
+            fprintf(stderr, "Error: Invalid breakpoint condition \"%s\"\n", condition);
+            return false;
+        }
+        if (find_conditional(address) < 0 && conditional_count >= MAX_CONDITIONS) {
+            fprintf(stderr, "Error: At most %d conditional breakpoints can be set\n", MAX_CONDITIONS);
+            return false;
+        }
+    }
+
+    remove_conditional(address);
+    if (condition) {
+        conditionals[conditional_count++] = (conditional_t){ address, compiled };
+    }
+    if (!test_bit(address)) {
+        uint16_t slot = address >> 1;
+        pc_bits[slot >> 3] |= 1 << (slot & 7);
+        breakpoint_count++;
+    }
+    return true;
+}
+
+bool breakpoint_clear(uint16_t address) {
+    address &= ~1;
+    if (!test_bit(address)) return false;
+    uint16_t slot = address >> 1;
+    pc_bits[slot >> 3] &= ~(1 << (slot & 7));
+    breakpoint_count--;
+    remove_conditional(address);
+    return true;
+}
+
+bool breakpoint_toggle(uint16_t address) {
+    if (breakpoint_clear(address)) return false;
+    return breakpoint_set(address, NULL);
+}
+
+bool breakpoint_at(uint16_t address) {
+    return test_bit(address);
+}
+
+// Rebuilds the page flags from the watchpoint list
+static void update_watch_pages(void) {
+    memset(watch_pages, 0, sizeof(watch_pages));
+    for (int i = 0; i < watchpoint_count; i++) {
+        for (int page = watchpoints[i].start >> WATCH_PAGE_SHIFT; page <= watchpoints[i].end >> WATCH_PAGE_SHIFT; page++) {
+            watch_pages[page] |= watchpoints[i].kind;
+        }
+    }
+}
+
+static int find_watchpoint(uint16_t start) {
+    for (int i = 0; i < watchpoint_count; i++) {
+        if (watchpoints[i].start == start) return i;
+    }
+    return -1;
+}
+
+bool watchpoint_set(uint16_t start, uint16_t length, uint8_t kind) {
+    kind &= WATCH_READ | WATCH_WRITE;
+    if (length == 0 || kind == 0 || (uint32_t)start + length > MEMORY_SIZE) {
+        fprintf(stderr, "Error: Invalid watchpoint at 0x%04X\n", start);
+        return false;
+    }
+    int index = find_watchpoint(start);
+    if (index < 0) {
+        if (watchpoint_count >= MAX_WATCHPOINTS) {
+            fprintf(stderr, "Error: At most %d watchpoints can be set\n", MAX_WATCHPOINTS);
+            return false;
+        }
+        index = watchpoint_count++;
+    }
+    watchpoints[index] = (watchpoint_t){ start, start + length - 1, kind };
+    update_watch_pages();
+    return true;
+}
+
+bool watchpoint_clear(uint16_t start) {
+    int index = find_watchpoint(start);
+    if (index < 0) return false;
+    watchpoints[index] = watchpoints[--watchpoint_count];
+    update_watch_pages();
+    return true;
+}
+
+void breakpoints_clear_all(void) {
+    memset(pc_bits, 0, sizeof(pc_bits));
+    breakpoint_count = 0;
+    conditional_count = 0;
+    watchpoint_count = 0;
+    memset(watch_pages, 0, sizeof(watch_pages));
+}
+
+bool breakpoints_active(void) {
+    return breakpoint_count > 0 || watchpoint_count > 0;
+}
+
+bool breakpoints_check(Cpu_t* cpu) {
+    uint16_t pc = cpu->pc;
+    if (test_bit(pc)) {
+        int index = conditional_count ? find_conditional(pc) : -1;
+        if (index < 0 || breakpoint_condition_holds(&conditionals[index].condition, cpu)) {
+            last_hit = (break_hit_t){ .reason = BREAK_PC, .pc = pc };
+            return true;
+        }
+    }
+    if (watchpoint_count == 0 || pc > RAM_END) return false;
+
+    shared i = decode(fetch(cpu));
+    uint16_t address, length;
+    bool write;
+    if (!cpu_data_access(&i, cpu, &address, &length, &write)) return false;
+    uint8_t kind = write ? WATCH_WRITE : WATCH_READ;
+    uint16_t last = address + length - 1;
+    if (!((watch_pages[address >> WATCH_PAGE_SHIFT] | watch_pages[last >> WATCH_PAGE_SHIFT]) & kind)) return false;
+
+    for (int w = 0; w < watchpoint_count; w++) {
+        if ((watchpoints[w].kind & kind) && address <= watchpoints[w].end && last >= watchpoints[w].start) {
+            last_hit = (break_hit_t){ .reason = BREAK_WATCH, .pc = pc, .address = address, .write = write };
+            return true;
+        }
+    }
+    return false;
+}
+
+const break_hit_t* breakpoints_last_hit(void) {
+    return &last_hit;
+}
+
+// "0x0010 (loop+0)", or just the address without labels
+static void format_address(uint16_t address, char* out, size_t size) {
+    uint16_t offset;
+    const char* label = labels_lookup(address, &offset);
+    if (label) snprintf(out, size, "0x%04X (%s+%u)", address, label, offset);
+    else snprintf(out, size, "0x%04X", address);
+}
+
+void breakpoints_print_hit(FILE* out) {
+    char pc[LABEL_NAME_LENGTH + 24];
+    format_address(last_hit.pc, pc, sizeof(pc));
+    if (last_hit.reason == BREAK_PC) {
+        fprintf(out, "Breakpoint at %s\n", pc);
+    } else if (last_hit.reason == BREAK_WATCH) {
+        fprintf(out, "Watchpoint: %s 0x%04X at %s\n", last_hit.write ? "write to" : "read from", last_hit.address, pc);
+    }
+}
+
+static void format_condition(const break_condition_t* condition, char* out, size_t size) {
+    char operand[16];
+    switch (condition->operand) {
+        case COND_REGISTER: snprintf(operand, sizeof(operand), "r%d", condition->index); break;
+        case COND_PC: snprintf(operand, sizeof(operand), "pc"); break;
+        case COND_MEMORY: snprintf(operand, sizeof(operand), "[0x%04X]", condition->address); break;
+        default: snprintf(operand, sizeof(operand), "%c", flag_names[condition->index]); break;
+    }
+    snprintf(out, size, "%s %s 0x%04X", operand, op_names[condition->op], condition->value);
+}
+
+void breakpoints_print(FILE* out) {
+    if (!breakpoints_active()) {
+        fprintf(out, "No breakpoints or watchpoints\n");
+        return;
+    }
+    char where[LABEL_NAME_LENGTH + 24];
+    for (uint32_t address = 0; address < MEMORY_SIZE; address += 2) {
+        if (!test_bit(address)) continue;
+        format_address(address, where, sizeof(where));
+        int index = find_conditional(address);
+        if (index >= 0) {
+            char condition[48];
+            format_condition(&conditionals[index].condition, condition, sizeof(condition));
+            fprintf(out, "break %s if %s\n", where, condition);
+        } else {
+            fprintf(out, "break %s\n", where);
+        }
+    }
+    for (int i = 0; i < watchpoint_count; i++) {
+        format_address(watchpoints[i].start, where, sizeof(where));
+        fprintf(out, "watch %s %u %s%s\n", where, watchpoints[i].end - watchpoints[i].start + 1,
+                watchpoints[i].kind & WATCH_READ ? "r" : "", watchpoints[i].kind & WATCH_WRITE ? "w" : "");
+    }
+}
+
+bool breakpoints_command(const char* command) {
+    char verb[16], where[LABEL_NAME_LENGTH];
+    const char* rest = next_token(command, verb, sizeof(verb));
+    rest = next_token(rest, where, sizeof(where));
+
+    if (strcmp(verb, "clear") == 0 && where[0] == '\0') {
+        breakpoints_clear_all();
+        return true;
+    }
+    if (strcmp(verb, "list") == 0 && where[0] == '\0') {
+        breakpoints_print(stdout);
+        return true;
+    }
+
+    uint16_t address;
+    if (!parse_value(where, &address)) {
+        fprintf(stderr, "Error: Unknown address or label \"%s\" in \"%s\"\n", where, command);
+        return false;
+    }
+
+    if (strcmp(verb, "break") == 0) {
+        rest = skip_spaces(rest);
+        if (*rest == '\0') return breakpoint_set(address, NULL);
+        if (strncmp(rest, "if", 2) == 0 && isspace((unsigned char)rest[2])) return breakpoint_set(address, rest + 3);
+    } else if (strcmp(verb, "watch") == 0) {
+        char token[16];
+        uint16_t length = 2;
+        uint8_t kind = WATCH_WRITE;
+        rest = next_token(rest, token, sizeof(token));
+        if (token[0] && isdigit((unsigned char)token[0])) {
+            if (!parse_value(token, &length)) token[0] = '?';
+            else rest = next_token(rest, token, sizeof(token));
+        }
+        if (token[0]) {
+            kind = strcmp(token, "r") == 0 ? WATCH_READ : strcmp(token, "w") == 0 ? WATCH_WRITE
+                 : strcmp(token, "rw") == 0 ? WATCH_READ | WATCH_WRITE : 0;
+        }
+        if (kind && *skip_spaces(rest) == '\0') return watchpoint_set(address, length, kind);
+    } else if (strcmp(verb, "delete") == 0 && *skip_spaces(rest) == '\0') {
+        bool removed = breakpoint_clear(address);
+        removed = watchpoint_clear(address) || removed;
+        if (!removed) fprintf(stderr, "Error: No breakpoint or watchpoint at 0x%04X\n", address);
+        return removed;
+    }
+    fprintf(stderr, "Error: Invalid debugger command \"%s\"\n", command);
+    return false;
+}
@@ -0,0 +1,91 @@
+#include "idn16/coverage.h"
+
+static coverage_t coverage;
+static bool enabled = false;
+
+void coverage_enable(bool on) {
+    enabled = on;
+}
+
+bool coverage_enabled(void) {
+    return enabled;
+}
+
+void coverage_reset(void) {
+    memset(&coverage, 0, sizeof(coverage));
+}
+
+coverage_t* coverage_data(void) {
+    return &coverage;
+}
+
+// JEQ, JNE, JGT and JLT: JB-format with a condition
+static bool is_conditional_branch(uint16_t instruction) {
+    uint8_t jb_type = (instruction >> 11) & 0b111;
+    return (instruction >> 14) == 0x02 && jb_type >= 0x01 && jb_type <= 0x04;
+}
+
+void coverage_record(uint16_t pc, uint16_t instruction, uint16_t next_pc) {
+    uint16_t slot = pc >> 1;
+    uint8_t bit = 1 << (slot & 7);
+    coverage.executed[slot >> 3] |= bit;
+    if (is_conditional_branch(instruction)) {
+        if (next_pc == (uint16_t)(pc + 2)) {
+            coverage.not_taken[slot >> 3] |= bit;
+        } else {
+            coverage.taken[slot >> 3] |= bit;
+        }
+    }
+}
+
+bool coverage_test(const uint8_t* bitmap, uint16_t address) {
+    uint16_t slot = address >> 1;
+    return (bitmap[slot >> 3] >> (slot & 7)) & 1;
+}
+
+void coverage_merge(coverage_t* into, const coverage_t* from) {
+    for (int i = 0; i < COVERAGE_BYTES; i++) {
+        into->executed[i] |= from->executed[i];
+        into->taken[i] |= from->taken[i];
+        into->not_taken[i] |= from->not_taken[i];
+    }
+}
+
+bool coverage_save(const coverage_t* data, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Error: Unable to write coverage file %s\n", path);
+        return false;
+    }
+    bool ok = fwrite(COVERAGE_MAGIC, 1, COVERAGE_MAGIC_LENGTH, file) == COVERAGE_MAGIC_LENGTH
+        && fputc(COVERAGE_VERSION, file) != EOF
+        && fwrite(data->executed, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES
+        && fwrite(data->taken, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES
+        && fwrite(data->not_taken, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) fprintf(stderr, "Error: Unable to write coverage file %s\n", path);
+    return ok;
+}
+
+bool coverage_load_merge(coverage_t* data, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Unable to open coverage file %s\n", path);
+        return false;
+    }
+    static coverage_t loaded;
+    char magic[COVERAGE_MAGIC_LENGTH];
+    bool ok = fread(magic, 1, COVERAGE_MAGIC_LENGTH, file) == COVERAGE_MAGIC_LENGTH
+        && memcmp(magic, COVERAGE_MAGIC, COVERAGE_MAGIC_LENGTH) == 0
+        && fgetc(file) == COVERAGE_VERSION
+        && fread(loaded.executed, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES
+        && fread(loaded.taken, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES
+        && fread(loaded.not_taken, 1, COVERAGE_BYTES, file) == COVERAGE_BYTES;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Error: %s is not an IDN-16 coverage file (version %d)\n", path, COVERAGE_VERSION);
+        return false;
+    }
+    coverage_merge(data, &loaded);
+    return true;
+}
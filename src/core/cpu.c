@@ -1,6 +1,9 @@
 #include "idn16/cpu.h"
+#include "idn16/cpu_step.h"
 #include "idn16/instructions.h"
 #include "idn16/dasm.h"
+#include "idn16/trace.h"
+#include "idn16/coverage.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -23,6 +26,7 @@ Cpu_t* cpu_init(void)
     cpu->flags.v = 0;
     cpu->flags.reserved = 0;
     cpu->cycles = 0;
+    cpu->instructions = 0;
     cpu->frame_count = 0;
     cpu->running = true;
     cpu->interrupt_pending = false;
@@ -42,13 +46,50 @@ void cpu_destroy(Cpu_t* cpu) {
 }
 
 void cpu_cycle(Cpu_t* cpu) {
-    if (cpu->pc > RAM_END) {
-        fprintf(stderr, "Error: Program counter out of bounds: 0x%4X\n", cpu->pc);
-        cpu->running = false;
-        return;
+    cpu_step_t step;
+    if (!cpu_step_begin(cpu, &step)) return;
+    cpu_step_end(cpu, &step);
+}
+
+void cpu_cycle_covered(Cpu_t* cpu) {
+    cpu_step_t step;
+    if (!cpu_step_begin(cpu, &step)) return;
+    cpu_step_end(cpu, &step);
+    coverage_record(step.pc, step.inst, cpu->pc);
+}
+
+void cpu_fault(Cpu_t* cpu, const char* reason) {
+    fprintf(stderr, "Error: %s: 0x%4X\n", reason, cpu->pc);
+    cpu->running = false;
+    trace_dump(stderr, TRACE_FAULT_RECORDS);
+}
+
+bool cpu_data_access(const shared* i, const Cpu_t* cpu, uint16_t* address, uint16_t* length, bool* write) {
+    switch (i->inst) {
+        case LDW: case LDB: case STW: case STB: {
+            int16_t offset = (i->third & 0x10) ? (int16_t)(i->third | 0xFFE0) : (int16_t)i->third;
+            *address = cpu->r[i->second] + offset;
+            *length = (i->inst == LDW || i->inst == STW) ? 2 : 1;
+            *write = i->inst == STW || i->inst == STB;
+            return true;
+        }
+        case LDBP: case LDWP: case STBP: case STWP:
+            *address = cpu->r[i->second];
+            *length = (i->inst == LDWP || i->inst == STWP) ? 2 : 1;
+            *write = i->inst == STBP || i->inst == STWP;
+            return true;
+        case PUSHM: case POPM: {
+            int words = 0;
+            for (uint16_t list = i->first; list; list &= list - 1) words++;
+            if (words == 0) return false;
+            *length = 2 * words;
+            *write = i->inst == PUSHM;
+            *address = *write ? cpu->r[6] - *length : cpu->r[6];
+            return true;
+        }
+        default:
+            return false;
     }
-    uint16_t inst = fetch(cpu);
-    execute(decode(inst), cpu);
 }
 
 uint16_t fetch(Cpu_t* cpu) {
@@ -215,6 +256,45 @@ shared sp_decode(uint16_t instruction) {
         i.second = (instruction >> 5) & 0b111;
         i.third = (instruction) & 0b11111;
         break;
+    case 0x06:
+        // Multiply/divide, REG-format operands
+        i.first = (instruction >> 8) & 0b111;
+        i.second = (instruction >> 5) & 0b111;
+        i.third = (instruction >> 2) & 0b111;
+        if ((instruction & 0b11) == 0b00) {
+            i.inst = MUL;
+        } else if ((instruction & 0b11) == 0b01) {
+            i.inst = MULH;
+        } else if ((instruction & 0b11) == 0b10) {
+            i.inst = DIV;
+        } else {
+            i.inst = MOD;
+        }
+        break;
+    case 0x07:
+        // Add/subtract with carry (REG-format operands), post-increment access and register lists
+        i.first = (instruction >> 8) & 0b111;
+        i.second = (instruction >> 5) & 0b111;
+        i.third = (instruction >> 2) & 0b111;
+        if ((instruction & 0b11) == 0b00) {
+            i.inst = ADC;
+        } else if ((instruction & 0b11) == 0b01) {
+            i.inst = SBC;
+        } else if ((instruction & 0b11) == 0b10 && i.third <= 0b011) {
+            // Post-increment memory access, the rs2 field selects the operation
+            static const uint16_t post_ops[4] = { LDBP, STBP, LDWP, STWP };
+            i.inst = post_ops[i.third];
+            i.third = 0;
+        } else if ((instruction & 0b11) == 0b11 && (instruction & 0x0300) == 0) {
+            // Register list: bit 10 selects POPM, bits 7-2 hold the list
+            i.inst = (instruction & 0x0400) ? POPM : PUSHM;
+            i.first = (instruction >> 2) & ((1 << REGLIST_BITS) - 1);
+            i.second = 0;
+            i.third = 0;
+        } else {
+            fprintf(stderr, "Error: Invalid SP-Instruction Used: 0x%04X -> %s.\n", instruction, disassemble_word(instruction));
+        }
+        break;
     default:
         fprintf(stderr, "Error: Invalid SP-Instruction Used: 0x%04X -> %s.\n", instruction, disassemble_word(instruction));
         break;
@@ -335,136 +415,45 @@ void execute(shared i, Cpu_t* cpu) {
         case STB:
             stb(i.first,i.second,i.third,cpu);
             break;
-        default:
-            // fprintf(stderr, "Error: Invalid Instruction Used: 0x%04X -> %s.\n", i.inst, disassemble_word(i.inst));
-            break;
-    }
-}
-
-void handle_system_call(uint16_t address, Cpu_t* cpu) {
-    switch (address) {
-        case SYSCALL_CLEAR_SCREEN:
-            syscall_clear_screen(cpu);
-            break;
-        case SYSCALL_PUT_CHAR:
-            syscall_put_char(cpu);
+        case MUL:
+            mul(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_PUT_STRING:
-            syscall_put_string(cpu);
+        case MULH:
+            mulh(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_SET_CURSOR:
-            syscall_set_cursor(cpu);
+        case DIV:
+            divu(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_GET_CURSOR:
-            syscall_get_cursor(cpu);
+        case MOD:
+            modu(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_PUT_CHAR_AT:
-            syscall_put_char_at(cpu);
+        case ADC:
+            adc(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_SCROLL_UP:
-            syscall_scroll_up(cpu);
+        case SBC:
+            sbc(i.first, i.second, i.third, cpu);
             break;
-        case SYSCALL_FILL_AREA:
-            syscall_fill_area(cpu);
+        case LDBP:
+            ldb_post(i.first, i.second, cpu);
             break;
-        case SYSCALL_SET_TEXT_COLOR:
-            syscall_set_text_color(cpu);
+        case STBP:
+            stb_post(i.first, i.second, cpu);
             break;
-        case SYSCALL_GET_INPUT:
-            syscall_get_input(cpu);
+        case LDWP:
+            ldw_post(i.first, i.second, cpu);
             break;
-        case SYSCALL_PLAY_TONE_CHANNEL:
-            syscall_play_tone_channel(cpu);
+        case STWP:
+            stw_post(i.first, i.second, cpu);
             break;
-        case SYSCALL_MULTIPLY:
-            syscall_multiply(cpu);
+        case PUSHM:
+            pushm(i.first, cpu);
             break;
-        case SYSCALL_DIVIDE:
-            syscall_divide(cpu);
-            break;
-        case SYSCALL_RANDOM:
-            syscall_random(cpu);
-            break;
-        case SYSCALL_MEMCPY:
-            syscall_memcpy(cpu);
-            break;
-        case SYSCALL_PRINT_HEX:
-            syscall_print_hex(cpu);
-            break;
-        case SYSCALL_PRINT_DEC:
-            syscall_print_dec(cpu);
-            break;
-        case SYSCALL_SET_SPRITE:
-            syscall_set_sprite(cpu);
-            break;
-        case SYSCALL_SET_PALETTE:
-            syscall_set_palette(cpu);
-            break;
-        case SYSCALL_MOVE_SPRITE:
-            syscall_move_sprite(cpu);
-            break;
-        case SYSCALL_SET_TILE_PIXEL:
-            syscall_set_tile_pixel(cpu);
-            break;
-        case SYSCALL_GET_FRAME_COUNT:
-            syscall_get_frame_count(cpu);
-            break;
-        case SYSCALL_HIDE_SPRITE:
-            syscall_hide_sprite(cpu);
-            break;
-        case SYSCALL_GET_SPRITE_POS:
-            syscall_get_sprite_pos(cpu);
-            break;
-        case SYSCALL_CLEAR_SPRITE_RANGE:
-            syscall_clear_sprite_range(cpu);
-            break;
-        case SYSCALL_CHECK_COLLISION:
-            syscall_check_collision(cpu);
-            break;
-        case SYSCALL_SHIFT_SPRITES:
-            syscall_shift_sprites(cpu);
-            break;
-        case SYSCALL_COPY_SPRITE:
-            syscall_copy_sprite(cpu);
-            break;
-        case SYSCALL_SET_RETURN_ADDR:
-            syscall_set_return_addr(cpu);
-            break;
-        case SYSCALL_MOVE_SPRITE_RIGHT:
-            syscall_move_sprite_right(cpu);
-            break;
-        case SYSCALL_MOVE_SPRITE_LEFT:
-            syscall_move_sprite_left(cpu);
-            break;
-        case SYSCALL_MOVE_SPRITE_UP:
-            syscall_move_sprite_up(cpu);
-            break;
-        case SYSCALL_MOVE_SPRITE_DOWN:
-            syscall_move_sprite_down(cpu);
-            break;
-        case SYSCALL_TIMER_START:
-            syscall_timer_start(cpu);
-            break;
-        case SYSCALL_TIMER_QUERY:
-            syscall_timer_query(cpu);
-            break;
-        case SYSCALL_SLEEP:
-            syscall_sleep(cpu);
-            break;
-        case SYSCALL_NUMBER_TO_STRING:
-            syscall_number_to_string(cpu);
-            break;
-        case SYSCALL_STOP_CHANNEL:
-            syscall_stop_channel(cpu);
-            break;
-        case SYSCALL_SET_MASTER_VOLUME:
-            syscall_set_master_volume(cpu);
-            break;
-        case SYSCALL_STOP_ALL_AUDIO:
-            syscall_stop_all_audio(cpu);
+        case POPM:
+            popm(i.first, cpu);
             break;
         default:
-            printf("Unknown system call: 0x%04X\n", address);
+            // fprintf(stderr, "Error: Invalid Instruction Used: 0x%04X -> %s.\n", i.inst, disassemble_word(i.inst));
             break;
     }
 }
+
@@ -392,4 +392,178 @@ void stb(uint16_t rd, uint16_t rs1, uint8_t imm, Cpu_t *cpu) {
     uint16_t address = cpu->r[rs1] + sign_extend_5(imm);
     memory_write_byte(cpu->memory, address, cpu->r[rd], false);
     cpu->pc += 2;
-}
\ No newline at end of file
+}
+void mul(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    uint32_t result32 = (uint32_t)cpu->r[rs1] * (uint32_t)cpu->r[rs2];
+    uint16_t result = (uint16_t)result32;
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    // C and V report that the product did not fit in 16 bits
+    cpu->flags.c = result32 > 0xFFFF;
+    cpu->flags.v = result32 > 0xFFFF;
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void mulh(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    // Upper word of the signed 32-bit product, for 8.8 fixed point and wide multiplies
+    int32_t product = (int32_t)(int16_t)cpu->r[rs1] * (int32_t)(int16_t)cpu->r[rs2];
+    uint16_t result = (uint16_t)((uint32_t)product >> 16);
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    cpu->flags.c = 0;
+    cpu->flags.v = 0;
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void divu(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    uint16_t divisor = cpu->r[rs2];
+    // Division by zero yields 0 and sets V instead of faulting
+    uint16_t result = divisor ? cpu->r[rs1] / divisor : 0;
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    cpu->flags.c = 0;
+    cpu->flags.v = (divisor == 0);
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void modu(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    uint16_t divisor = cpu->r[rs2];
+    uint16_t result = divisor ? cpu->r[rs1] % divisor : 0;
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    cpu->flags.c = 0;
+    cpu->flags.v = (divisor == 0);
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void adc(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    uint16_t rs1_val = cpu->r[rs1];
+    uint16_t rs2_val = cpu->r[rs2];
+    uint32_t result32 = (uint32_t)rs1_val + (uint32_t)rs2_val + cpu->flags.c;
+    uint16_t result = (uint16_t)result32;
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    cpu->flags.c = result32 > 0xFFFF;
+    cpu->flags.v = ((~(rs1_val ^ rs2_val) & (rs1_val ^ result)) & 0x8000) != 0;
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void sbc(uint16_t rd, uint16_t rs1, uint16_t rs2, Cpu_t *cpu) {
+    if (rd == 0) {
+        cpu->r[0] = 0;
+        cpu->pc += 2;
+        return;   
+    }
+    // Same carry convention as SUB: C set means no borrow, so a clear C borrows one
+    uint16_t rs1_val = cpu->r[rs1];
+    uint16_t rs2_val = cpu->r[rs2];
+    uint32_t subtrahend = (uint32_t)rs2_val + (cpu->flags.c ? 0 : 1);
+    uint16_t result = (uint16_t)(rs1_val - subtrahend);
+
+    cpu->flags.z = (result == 0);
+    cpu->flags.n = (result & 0x8000) != 0;
+    cpu->flags.c = (rs1_val >= subtrahend);
+    cpu->flags.v = (((rs1_val ^ rs2_val) & (rs1_val ^ result)) & 0x8000) != 0;
+    cpu->r[rd] = result;
+    cpu->pc += 2;
+}
+void ldb_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu) {
+    uint16_t address = cpu->r[rs1];
+    // The pointer is advanced first, so a load into the pointer register keeps the loaded value
+    if (rs1 != 0) {
+        cpu->r[rs1] = address + 1;
+    }
+    if (rd != 0) {
+        cpu->r[rd] = memory_read_byte(cpu->memory, address);
+        cpu->flags.z = (cpu->r[rd] == 0);
+        cpu->flags.n = (cpu->r[rd] & 0x8000) != 0;
+        cpu->flags.c = 0;
+        cpu->flags.v = 0;
+    }
+    cpu->pc += 2;
+}
+void stb_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu) {
+    memory_write_byte(cpu->memory, cpu->r[rs1], cpu->r[rd], false);
+    if (rs1 != 0) {
+        cpu->r[rs1] += 1;
+    }
+    cpu->pc += 2;
+}
+void ldw_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu) {
+    uint16_t address = cpu->r[rs1];
+    if (rs1 != 0) {
+        cpu->r[rs1] = address + 2;
+    }
+    if (rd != 0) {
+        cpu->r[rd] = memory_read_word(cpu->memory, address);
+        cpu->flags.z = (cpu->r[rd] == 0);
+        cpu->flags.n = (cpu->r[rd] & 0x8000) != 0;
+        cpu->flags.c = 0;
+        cpu->flags.v = 0;
+    }
+    cpu->pc += 2;
+}
+void stw_post(uint16_t rd, uint16_t rs1, Cpu_t *cpu) {
+    memory_write_word(cpu->memory, cpu->r[rs1], cpu->r[rd], false);
+    if (rs1 != 0) {
+        cpu->r[rs1] += 2;
+    }
+    cpu->pc += 2;
+}
+
+// Maps a register list bit to its register: bits 0-4 are r1-r5, bit 5 is ra
+static uint16_t reglist_register(int bit) {
+    return bit == REGLIST_BITS - 1 ? 7 : bit + 1;
+}
+
+void pushm(uint16_t reglist, Cpu_t *cpu) {
+    // Same layout as a PUSH per listed register in ascending order:
+    // the lowest register ends up at the highest address
+    for (int bit = 0; bit < REGLIST_BITS; bit++) {
+        if (reglist & (1 << bit)) {
+            cpu->r[6] -= 2;
+            memory_write_word(cpu->memory, cpu->r[6], cpu->r[reglist_register(bit)], false);
+        }
+    }
+    cpu->pc += 2;
+}
+void popm(uint16_t reglist, Cpu_t *cpu) {
+    // Undoes pushm with the same list
+    for (int bit = REGLIST_BITS - 1; bit >= 0; bit--) {
+        if (reglist & (1 << bit)) {
+            cpu->r[reglist_register(bit)] = memory_read_word(cpu->memory, cpu->r[6]);
+            cpu->r[6] += 2;
+        }
+    }
+    cpu->pc += 2;
+}
@@ -164,6 +164,12 @@ void audio_update(uint8_t *memory) {
     }
 }
 
+uint32_t audio_queued_bytes(void) {
+    if (!audio_stream) return 0;
+    int queued = SDL_GetAudioStreamQueued(audio_stream);
+    return queued > 0 ? (uint32_t)queued : 0;
+}
+
 void audio_set_enabled(bool enabled) {
     audio_enabled = enabled;
 }
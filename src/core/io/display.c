@@ -1,8 +1,171 @@
 #include "idn16/io/display.h"
 #include "idn16/memory.h"
+#include "idn16/video.h"
 #include <string.h>
 #include "font8x8/font8x8_basic.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Copies one 8-pixel (16 byte) RGB565 row
+static inline void blit_row(uint16_t* dest, const uint16_t* src) {
+#if defined(__SSE2__)
+    _mm_storeu_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)src));
+#elif defined(__ARM_NEON)
+    vst1q_u16(dest, vld1q_u16(src));
+#else
+    uint64_t lo, hi;
+    memcpy(&lo, src, sizeof(lo));
+    memcpy(&hi, src + 4, sizeof(hi));
+    memcpy(dest, &lo, sizeof(lo));
+    memcpy(dest + 4, &hi, sizeof(hi));
+#endif
+}
+
+// Copies one 8-pixel (32 byte) XRGB8888 row
+static inline void blit_row32(uint32_t* dest, const uint32_t* src) {
+#if defined(__SSE2__)
+    _mm_storeu_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)src));
+    _mm_storeu_si128((__m128i*)(dest + 4), _mm_loadu_si128((const __m128i*)(src + 4)));
+#elif defined(__ARM_NEON)
+    vst1q_u32(dest, vld1q_u32(src));
+    vst1q_u32(dest + 4, vld1q_u32(src + 4));
+#else
+    memcpy(dest, src, TILE_SIZE * sizeof(uint32_t));
+#endif
+}
+
+// Copies an expanded 8x8 tile to the pixel buffer at (x, y), in whichever format the display outputs
+static inline void blit_tile(display_t* display, const uint16_t* tile, const uint32_t* tile32, int x, int y) {
+    if (x < 0 || y < 0 || x + TILE_SIZE > display->width || y + TILE_SIZE > display->height) return;
+    if (display->true_color) {
+        uint32_t* dest = (uint32_t*)display->pixels + y * display->width + x;
+        for (int row = 0; row < TILE_SIZE; row++) {
+            blit_row32(dest, tile32 + row * TILE_SIZE);
+            dest += display->width;
+        }
+    } else {
+        uint16_t* dest = (uint16_t*)display->pixels + y * display->width + x;
+        for (int row = 0; row < TILE_SIZE; row++) {
+            blit_row(dest, tile + row * TILE_SIZE);
+            dest += display->width;
+        }
+    }
+}
+
+// Reads a byte of the snapshot being rasterised by its guest address
+#define FRAME_VRAM(display, address) ((display)->frame->vram + ((address) - VIDEO_RAM_START))
+
+// Reads a word from the snapshot; memory_write_word stores words in host byte order
+static inline uint16_t frame_read_word(const display_t* display, uint16_t address) {
+    uint16_t word;
+    memcpy(&word, FRAME_VRAM(display, address), sizeof(word));
+    return word;
+}
+
+// Creates the streaming texture and both framebuffers for the current output format
+static bool create_framebuffer(display_t* display) {
+    display->bytes_per_pixel = display->true_color ? sizeof(uint32_t) : sizeof(uint16_t);
+    display->texture = SDL_CreateTexture(
+        display->renderer,
+        display->true_color ? SDL_PIXELFORMAT_XRGB8888 : SDL_PIXELFORMAT_RGB565,
+        SDL_TEXTUREACCESS_STREAMING,
+        display->width,
+        display->height
+    );
+
+    if (!display->texture) {
+        printf("Failed to create texture: %s\n", SDL_GetError());
+        return false;
+    }
+
+    size_t size = display->width * display->height * display->bytes_per_pixel;
+    for (int i = 0; i < 2; i++) {
+        // Zeroed memory is black in both formats
+        display->framebuffers[i] = calloc(1, size);
+        if (!display->framebuffers[i]) {
+            printf("Failed to allocate pixel buffer\n");
+            free(display->framebuffers[0]);
+            display->framebuffers[0] = NULL;
+            SDL_DestroyTexture(display->texture);
+            display->texture = NULL;
+            return false;
+        }
+    }
+
+    // Start out showing a black frame
+    display->ready_buffer = 0;
+    display->ready_uploaded = false;
+    return true;
+}
+
+static void destroy_framebuffer(display_t* display) {
+    for (int i = 0; i < 2; i++) {
+        free(display->framebuffers[i]);
+        display->framebuffers[i] = NULL;
+    }
+    if (display->texture) {
+        SDL_DestroyTexture(display->texture);
+        display->texture = NULL;
+    }
+}
+
+static int render_thread_main(void* data) {
+    display_t* display = data;
+
+    SDL_LockMutex(display->render_lock);
+    while (true) {
+        while (display->pending_frame < 0 && !display->render_quit) {
+            SDL_WaitCondition(display->render_cond, display->render_lock);
+        }
+        if (display->render_quit) break;
+
+        int slot = display->pending_frame;
+        display->pending_frame = -1;
+        display->rendering_frame = slot;
+        // Draw into whichever buffer does not hold the last finished frame
+        int buffer = display->ready_buffer == 0 ? 1 : 0;
+        SDL_UnlockMutex(display->render_lock);
+
+        uint64_t start = SDL_GetTicksNS();
+        display_render_frame(display, &display->frames[slot], display->framebuffers[buffer]);
+        uint64_t elapsed = SDL_GetTicksNS() - start;
+
+        SDL_LockMutex(display->render_lock);
+        display->raster_ns += elapsed;
+        display->rendering_frame = -1;
+        display->ready_buffer = buffer;
+        display->ready_uploaded = false;
+        display->frames_rendered++;
+    }
+    SDL_UnlockMutex(display->render_lock);
+    return 0;
+}
+
+static void start_render_thread(display_t* display) {
+    display->pending_frame = -1;
+    display->rendering_frame = -1;
+    display->render_quit = false;
+    display->render_thread = SDL_CreateThread(render_thread_main, "idn16 render", display);
+    if (!display->render_thread) {
+        // Frames are then rasterised inline by display_submit_frame
+        printf("Failed to create render thread: %s\n", SDL_GetError());
+    }
+}
+
+static void stop_render_thread(display_t* display) {
+    if (!display->render_thread) return;
+    SDL_LockMutex(display->render_lock);
+    display->render_quit = true;
+    SDL_SignalCondition(display->render_cond);
+    SDL_UnlockMutex(display->render_lock);
+    SDL_WaitThread(display->render_thread, NULL);
+    display->render_thread = NULL;
+}
+
 display_t* display_init(int width, int height, int scale, uint8_t memory[], SDL_Renderer *renderer, TTF_Font *font) {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         printf("Failed to initialize SDL: %s\n", SDL_GetError());
@@ -26,26 +189,15 @@ display_t* display_init(int width, int height, int scale, uint8_t memory[], SDL_
     display->renderer = renderer;
     display->memory = memory;
 
-    // Create texture for text rendering
-    display->texture = SDL_CreateTexture(
-        display->renderer,
-        SDL_PIXELFORMAT_RGB565,
-        SDL_TEXTUREACCESS_STREAMING,
-        width,
-        height
-    );
+    display->true_color = false;
+    display->framebuffers[0] = NULL;
+    display->framebuffers[1] = NULL;
+    display->texture = NULL;
+    display->frame = NULL;
+    display->pixels = NULL;
 
-    if (!display->texture) {
-        printf("Failed to create texture: %s\n", SDL_GetError());
-        free(display);
-        return NULL;
-    }
-
-    // Allocate pixel buffer
-    display->pixels = malloc(width * height * sizeof(uint16_t));
-    if (!display->pixels) {
-        printf("Failed to allocate pixel buffer\n");
-        SDL_DestroyTexture(display->texture);
+    // Create texture and framebuffers (RGB565 until true color is requested)
+    if (!create_framebuffer(display)) {
         free(display);
         return NULL;
     }
@@ -61,46 +213,175 @@ display_t* display_init(int width, int height, int scale, uint8_t memory[], SDL_
     display->char_width = 8;
     display->char_height = 8;
 
-    clear_screen_buffer(display, 0x0000);
     display->frames_rendered = 0;
+    display->raster_ns = 0;
+    display->dirty_cells = 0;
+    memset(display->last_chars, 0, sizeof(display->last_chars));
+    display->frames_dropped = 0;
+
+    // Generation 0 is never current, so every cache entry starts out stale
+    memset(display->tile_cache_generation, 0, sizeof(display->tile_cache_generation));
+    display->tile_cache_palette_generation = 0;
+    display->glyph_cache_valid = false;
+
+    display->render_lock = SDL_CreateMutex();
+    display->render_cond = SDL_CreateCondition();
+    if (!display->render_lock || !display->render_cond) {
+        printf("Failed to create render thread lock: %s\n", SDL_GetError());
+        if (display->render_lock) SDL_DestroyMutex(display->render_lock);
+        if (display->render_cond) SDL_DestroyCondition(display->render_cond);
+        destroy_framebuffer(display);
+        free(display);
+        return NULL;
+    }
+    start_render_thread(display);
 
     return display;
 }
 
 void display_destroy(display_t* display) {
     if (display) {
-        if (display->pixels) {
-            free(display->pixels);
-        }
-        if (display->texture) {
-            SDL_DestroyTexture(display->texture);
-        }
+        stop_render_thread(display);
+        SDL_DestroyCondition(display->render_cond);
+        SDL_DestroyMutex(display->render_lock);
+        destroy_framebuffer(display);
         free(display);
     }
     TTF_Quit();
 }
 
+bool display_set_true_color(display_t* display, bool true_color) {
+    if (!display) return false;
+    if (display->true_color == true_color) return true;
+
+    // The render thread owns the framebuffers while it runs
+    stop_render_thread(display);
+    destroy_framebuffer(display);
+    display->true_color = true_color;
+    bool ok = create_framebuffer(display);
+    if (!ok) {
+        // Fall back to the previous format so the display stays usable
+        display->true_color = !true_color;
+        create_framebuffer(display);
+    }
+    start_render_thread(display);
+    return ok;
+}
+
+// Copies the background registers and the tilemap they point at into frame
+static void snapshot_background(uint8_t memory[], display_frame_t* frame) {
+    frame->bg_enabled = video_background_read(memory, &frame->bg);
+    if (!frame->bg_enabled) return;
+    memcpy(frame->bg_map, memory + frame->bg.map_address, frame->bg.map_width * frame->bg.map_height);
+}
+
+void display_submit_frame(display_t* display) {
+    if (!display) return;
+
+    SDL_LockMutex(display->render_lock);
+    uint64_t start = SDL_GetTicksNS();
+    // Never overwrite the snapshot the render thread is reading
+    int slot = display->rendering_frame == 0 ? 1 : 0;
+    if (display->pending_frame >= 0) {
+        display->frames_dropped++;
+    }
+    display_frame_t* frame = &display->frames[slot];
+    memcpy(frame->vram, display->memory + VIDEO_RAM_START, DISPLAY_VRAM_SIZE);
+
+    // Count the character cells that changed since the last submitted frame
+    const uint8_t* chars = frame->vram + (CHAR_BUFFER_START - VIDEO_RAM_START);
+    for (size_t i = 0; i < sizeof(display->last_chars); i++) {
+        display->dirty_cells += chars[i] != display->last_chars[i];
+    }
+    memcpy(display->last_chars, chars, sizeof(display->last_chars));
+    video_state_snapshot(&frame->video);
+    snapshot_background(display->memory, frame);
+
+    // The snapshot counts as rasterising time; without a render thread so does the drawing
+    if (display->render_thread) {
+        display->pending_frame = slot;
+        SDL_SignalCondition(display->render_cond);
+        display->raster_ns += SDL_GetTicksNS() - start;
+    } else {
+        int buffer = display->ready_buffer == 0 ? 1 : 0;
+        display_render_frame(display, frame, display->framebuffers[buffer]);
+        display->raster_ns += SDL_GetTicksNS() - start;
+        display->ready_buffer = buffer;
+        display->ready_uploaded = false;
+        display->frames_rendered++;
+    }
+    SDL_UnlockMutex(display->render_lock);
+}
+
 void display_update(display_t* display, SDL_FRect *where) {
     if (!display) return;
-    
+
+    // Upload the newest finished frame; the render thread keeps drawing into the other buffer
+    SDL_LockMutex(display->render_lock);
+    if (display->ready_buffer >= 0 && !display->ready_uploaded) {
+        SDL_UpdateTexture(display->texture, NULL, display->framebuffers[display->ready_buffer],
+                          display->width * display->bytes_per_pixel);
+        display->ready_uploaded = true;
+    }
+    SDL_UnlockMutex(display->render_lock);
+}
+
+void display_take_counters(display_t* display, uint64_t* raster_ns, uint32_t* dirty_cells) {
+    *raster_ns = 0;
+    *dirty_cells = 0;
+    if (!display) return;
+
+    SDL_LockMutex(display->render_lock);
+    *raster_ns = display->raster_ns;
+    *dirty_cells = display->dirty_cells;
+    display->raster_ns = 0;
+    display->dirty_cells = 0;
+    SDL_UnlockMutex(display->render_lock);
+}
+
+bool display_frame_waiting(display_t* display) {
+    if (!display) return false;
+
+    SDL_LockMutex(display->render_lock);
+    bool waiting = display->pending_frame >= 0 || display->rendering_frame >= 0
+        || (display->ready_buffer >= 0 && !display->ready_uploaded);
+    SDL_UnlockMutex(display->render_lock);
+    return waiting;
+}
+
+void display_render_frame(display_t* display, const display_frame_t* frame, void* pixels) {
+    display->frame = frame;
+    display->pixels = pixels;
+
     // Clear screen with black background
     clear_screen_buffer(display, 0x0000);
     
+    // Background layer sits under sprites
+    render_background(display);
+
     // Also render sprites if they exist
     render_sprites(display);
 
     render_text(display);
 
-    // Update texture for rendering
-    SDL_UpdateTexture(display->texture, NULL, display->pixels, display->width * sizeof(uint16_t));
-    
-    display->frames_rendered++;
+    display->frame = NULL;
+    display->pixels = NULL;
 }
 
 
 void clear_screen_buffer(display_t* display, uint16_t color) {
-    for (int i = 0; i < display->width * display->height; i++) {
-        display->pixels[i] = color;
+    int count = display->width * display->height;
+    if (display->true_color) {
+        uint32_t* pixels = display->pixels;
+        uint32_t color32 = video_rgb565_to_xrgb8888(color);
+        for (int i = 0; i < count; i++) {
+            pixels[i] = color32;
+        }
+    } else {
+        uint16_t* pixels = display->pixels;
+        for (int i = 0; i < count; i++) {
+            pixels[i] = color;
+        }
     }
 }
 
@@ -112,59 +393,74 @@ uint16_t rgb_to_rgb565(uint8_t r, uint8_t g, uint8_t b) {
 void render_text(display_t* display) {
     if (!display->font) return;
 
-    // Read text colors once per frame for performance
-    uint16_t fg_color = memory_read_word(display->memory, VIDEO_CONTROL_START + 10);
-    uint16_t bg_color = memory_read_word(display->memory, VIDEO_CONTROL_START + 12);
-    
-    // Use default colors if not set
-    if (fg_color == 0 && bg_color == 0) {
-        fg_color = 0xFFFF; // White
-        bg_color = 0x0000; // Black
-    }
+    // Text colors were resolved when the frame was snapshotted
+    uint16_t fg_color = display->frame->video.text_fg_color;
+    uint16_t bg_color = display->frame->video.text_bg_color;
 
+    // The character buffer is a ring; the scroll registers pick the cell drawn at the top left
+    int scroll_x = frame_read_word(display, TEXT_SCROLL_X_REG) % SCREEN_WIDTH_TILES;
+    int scroll_y = frame_read_word(display, TEXT_SCROLL_Y_REG) % SCREEN_HEIGHT_TILES;
 
     // Render text grid (40x30 characters) - read from character buffer
+    const uint8_t* chars = FRAME_VRAM(display, CHAR_BUFFER_START);
     for (int tile_y = 0; tile_y < SCREEN_HEIGHT_TILES; tile_y++) {
+        const uint8_t* row = chars + ((tile_y + scroll_y) % SCREEN_HEIGHT_TILES) * SCREEN_WIDTH_TILES;
         for (int tile_x = 0; tile_x < SCREEN_WIDTH_TILES; tile_x++) {
-            // Read character from buffer at 0xD000-0xD4AF
-            uint16_t buffer_addr = CHAR_BUFFER_START + (tile_y * SCREEN_WIDTH_TILES + tile_x);
-            uint8_t ch = memory_read_byte(display->memory, buffer_addr);
+            uint8_t ch = row[(tile_x + scroll_x) % SCREEN_WIDTH_TILES];
             
             // Skip rendering empty/invisible characters
-            if (ch < 32 || ch > 126) continue;
+            if (ch < GLYPH_FIRST || ch > GLYPH_LAST) continue;
 
-            // Get 8x8 bitmap glyph from font
-            const uint8_t* glyph = font8x8_basic[ch];
-            
-            // Position character at tile location
-            int pixel_x = tile_x * 8;
-            int pixel_y = tile_y * 8;
-            
-            // Render 8x8 bitmap directly to pixel buffer
-            for (int row = 0; row < 8; row++) {
-                uint8_t bits = glyph[row];
-                for (int col = 0; col < 8; col++) {
-                    // Check if bit is set (foreground) or clear (background)
-                    uint16_t color = (bits & (1 << col)) ? fg_color : bg_color;
-                    
-                    int px = pixel_x + col;
-                    int py = pixel_y + row;
-                    if (px >= 0 && px < display->width && py >= 0 && py < display->height) {
-                        display->pixels[py * display->width + px] = color;
-                    }
+            const uint16_t* glyph = get_cached_glyph(display, ch, fg_color, bg_color);
+            blit_tile(display, glyph, display->glyph_cache32[ch - GLYPH_FIRST], tile_x * TILE_SIZE, tile_y * TILE_SIZE);
+        }
+    }
+}
+
+void render_background(display_t* display) {
+    const display_frame_t* frame = display->frame;
+    if (!frame->bg_enabled) return;
+
+    const video_background_t* bg = &frame->bg;
+    for (int y = 0; y < display->height; y++) {
+        int map_y = video_background_wrap(y, bg->scroll_y, bg->map_height);
+        const uint8_t* map_row = frame->bg_map + (map_y / TILE_SIZE) * bg->map_width;
+        int tile_row = map_y % TILE_SIZE;
+
+        // Copy one run of pixels per tile the row crosses
+        int x = 0;
+        while (x < display->width) {
+            int map_x = video_background_wrap(x, bg->scroll_x, bg->map_width);
+            int tile_col = map_x % TILE_SIZE;
+            int count = TILE_SIZE - tile_col;
+            if (count > display->width - x) count = display->width - x;
+
+            uint8_t tile_id = map_row[map_x / TILE_SIZE];
+            if (tile_id != 0 && tile_id < MAX_TILES) {
+                const uint16_t* tile = get_cached_tile(display, tile_id);
+                int offset = tile_row * TILE_SIZE + tile_col;
+                if (display->true_color) {
+                    uint32_t* dest = (uint32_t*)display->pixels + y * display->width + x;
+                    memcpy(dest, display->tile_cache32[tile_id - 1] + offset, count * sizeof(uint32_t));
+                } else {
+                    uint16_t* dest = (uint16_t*)display->pixels + y * display->width + x;
+                    memcpy(dest, tile + offset, count * sizeof(uint16_t));
                 }
             }
+            x += count;
         }
     }
 }
 
 // Sprite rendering functions
 void render_sprites(display_t* display) {
-    for (int i = 0; i < MAX_SPRITES; i++) {
-        uint16_t sprite_addr = SPRITE_TABLE_START + (i * 3);
-        uint8_t sprite_x = memory_read_byte(display->memory, sprite_addr + 0);
-        uint8_t sprite_y = memory_read_byte(display->memory, sprite_addr + 1);
-        uint8_t tile_id = memory_read_byte(display->memory, sprite_addr + 2);
+    const video_snapshot_t* video = &display->frame->video;
+    // Walk only the active sprites, in table order so overlap order is preserved
+    for (uint16_t i = video_snapshot_next_active_sprite(video, 0); i < MAX_SPRITES; i = video_snapshot_next_active_sprite(video, i + 1)) {
+        const uint8_t* sprite = FRAME_VRAM(display, SPRITE_TABLE_START + (i * 3));
+        uint8_t sprite_x = sprite[0];
+        uint8_t sprite_y = sprite[1];
+        uint8_t tile_id = sprite[2];
         
         // Skip if sprite is disabled (tile_id = 0) or off-screen
         if (tile_id == 0 || tile_id >= MAX_TILES || sprite_x >= SCREEN_WIDTH_TILES || sprite_y >= SCREEN_HEIGHT_TILES) {
@@ -172,47 +468,88 @@ void render_sprites(display_t* display) {
         }
         
         // Convert tile coordinates to pixel coordinates
-        render_sprite_to_buffer(display, tile_id, sprite_x * 8, sprite_y * 8);
+        render_sprite_to_buffer(display, tile_id, sprite_x * TILE_SIZE, sprite_y * TILE_SIZE);
     }
 }
 
 void render_sprite_to_buffer(display_t* display, uint8_t id, uint16_t x, uint16_t y) {
-    // Calculate address of sprite pixel data (64 bytes per 8x8 sprite)
+    if (id == 0 || id > MAX_TILES) return;
+    const uint16_t* tile = get_cached_tile(display, id);
+    blit_tile(display, tile, display->tile_cache32[id - 1], x, y);
+}
+
+const uint16_t* get_cached_tile(display_t* display, uint8_t id) {
     // tile_id=1 refers to first tile at TILESET_DATA_START, so offset by (id-1)
-    uint16_t sprite_data_addr = TILESET_DATA_START + ((id - 1) * 64);
+    uint8_t index = id - 1;
+
+    // A palette change invalidates every expanded tile
+    uint32_t palette_generation = display->frame->video.palette_generation;
+    if (display->tile_cache_palette_generation != palette_generation) {
+        memset(display->tile_cache_generation, 0, sizeof(display->tile_cache_generation));
+        display->tile_cache_palette_generation = palette_generation;
+    }
+
+    uint32_t tile_generation = display->frame->video.tile_generation[index];
+    uint16_t* tile = display->tile_cache[index];
+    if (display->tile_cache_generation[index] == tile_generation) {
+        return tile;
+    }
+
+    // Expand the 64 palette indices of this tile (64 bytes per 8x8 sprite)
+    const uint8_t* data = FRAME_VRAM(display, TILESET_DATA_START + (index * TILE_SIZE * TILE_SIZE));
     
+    const uint32_t* palette32 = display->frame->video.palette_xrgb8888;
+    uint32_t* tile32 = display->tile_cache32[index];
+
     // Track previous valid palette index for this tile
     uint8_t prev_palette_index = 0; // Default to palette 0
-    
-    // Render 8x8 sprite using pixel data
-    for (int py = 0; py < 8; py++) {
-        for (int px = 0; px < 8; px++) {
-            // Get palette index for this pixel
-            uint8_t palette_index = memory_read_byte(display->memory, sprite_data_addr + (py * 8 + px));
-            
-            // Use previous valid palette if index is 16+
-            if (palette_index >= PALETTE_SIZE) {
-                palette_index = prev_palette_index;
-            } else if (palette_index > 0 && palette_index < PALETTE_SIZE) {
-                prev_palette_index = palette_index; // Update previous valid index
-            }
-            int final_x = x + px;
-            int final_y = y + py;
-            
-            if (final_x >= 0 && final_x < display->width &&
-                final_y >= 0 && final_y < display->height) {
-                uint16_t color = get_palette_color(display, palette_index);
-                display->pixels[final_y * display->width + final_x] = color;
+    for (int i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+        uint8_t palette_index = data[i];
+
+        // Use previous valid palette if index is 16+
+        if (palette_index >= PALETTE_SIZE) {
+            palette_index = prev_palette_index;
+        } else if (palette_index > 0) {
+            prev_palette_index = palette_index; // Update previous valid index
+        }
+        tile[i] = get_palette_color(display, palette_index);
+        // Index 0 maps to palette entry 1, as in get_palette_color
+        tile32[i] = palette32[palette_index ? palette_index : 1];
+    }
+    display->tile_cache_generation[index] = tile_generation;
+    return tile;
+}
+
+const uint16_t* get_cached_glyph(display_t* display, uint8_t ch, uint16_t fg_color, uint16_t bg_color) {
+    // Text colors are global, so only the current pair needs to be kept
+    if (!display->glyph_cache_valid || display->glyph_cache_fg != fg_color || display->glyph_cache_bg != bg_color) {
+        uint32_t fg_color32 = video_rgb565_to_xrgb8888(fg_color);
+        uint32_t bg_color32 = video_rgb565_to_xrgb8888(bg_color);
+        for (int c = 0; c < GLYPH_COUNT; c++) {
+            const uint8_t* glyph = (const uint8_t*)font8x8_basic[GLYPH_FIRST + c];
+            uint16_t* out = display->glyph_cache[c];
+            uint32_t* out32 = display->glyph_cache32[c];
+            for (int row = 0; row < TILE_SIZE; row++) {
+                uint8_t bits = glyph[row];
+                for (int col = 0; col < TILE_SIZE; col++) {
+                    // Check if bit is set (foreground) or clear (background)
+                    bool set = (bits & (1 << col)) != 0;
+                    out[row * TILE_SIZE + col] = set ? fg_color : bg_color;
+                    out32[row * TILE_SIZE + col] = set ? fg_color32 : bg_color32;
+                }
             }
         }
+        display->glyph_cache_fg = fg_color;
+        display->glyph_cache_bg = bg_color;
+        display->glyph_cache_valid = true;
     }
+    return display->glyph_cache[ch - GLYPH_FIRST];
 }
 
 uint16_t get_palette_color(display_t *display, uint8_t palette_index) {
     // Palette index should be 1-15 when this function is called
     if (palette_index == 0 || palette_index >= PALETTE_SIZE) palette_index = 1;
-    uint16_t color_addr = PALETTE_RAM_START + (palette_index * 2);
-    return memory_read_word(display->memory, color_addr);
-}
-
-
+    // Served from the frame's copy of the host-side lookup table
+    const uint16_t* palette = display->frame ? display->frame->video.palette_rgb565 : video_palette_rgb565();
+    return palette[palette_index];
+}
\ No newline at end of file
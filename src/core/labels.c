@@ -0,0 +1,88 @@
+#include "idn16/labels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint16_t address;
+    char name[LABEL_NAME_LENGTH];
+} label_t;
+
+// Sorted by address
+static label_t labels[MAX_LABELS];
+static int label_count = 0;
+
+static int compare_label_address(const void* a, const void* b) {
+    const label_t* la = a;
+    const label_t* lb = b;
+    return (la->address > lb->address) - (la->address < lb->address);
+}
+
+bool labels_load(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    label_count = 0;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned int address;
+        char name[LABEL_NAME_LENGTH];
+        // Longer names are cut to fit
+        if (sscanf(line, "%x %63s", &address, name) != 2 || address > 0xFFFF) continue;
+        if (label_count >= MAX_LABELS) {
+            fprintf(stderr, "Warning: Only the first %d labels of %s are used\n", MAX_LABELS, path);
+            break;
+        }
+        labels[label_count].address = (uint16_t)address;
+        memcpy(labels[label_count].name, name, sizeof(name));
+        label_count++;
+    }
+    fclose(file);
+    qsort(labels, label_count, sizeof(labels[0]), compare_label_address);
+    return true;
+}
+
+void labels_clear(void) {
+    label_count = 0;
+}
+
+int labels_count(void) {
+    return label_count;
+}
+
+int labels_index(uint16_t address) {
+    int low = 0, high = label_count - 1, found = -1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (labels[mid].address <= address) {
+            found = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return found;
+}
+
+const char* labels_name(int index) {
+    return labels[index].name;
+}
+
+bool labels_find(const char* name, uint16_t* address) {
+    for (int i = 0; i < label_count; i++) {
+        if (strcmp(labels[i].name, name) == 0) {
+            *address = labels[i].address;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* labels_lookup(uint16_t address, uint16_t* offset) {
+    int index = labels_index(address);
+    if (index < 0) return NULL;
+    if (offset) *offset = address - labels[index].address;
+    return labels[index].name;
+}
@@ -0,0 +1,38 @@
+#include "idn16/listing.h"
+#include "idn16/labels.h"
+#include "idn16/dasm.h"
+
+static char lines[LISTING_WORDS][LISTING_LINE_LENGTH];
+static uint16_t line_words[LISTING_WORDS];   // Word each line was formatted from
+static uint8_t line_valid[LISTING_WORDS];
+static uint32_t format_count = 0;
+
+static void format_line(uint16_t slot, uint16_t word) {
+    uint16_t address = slot * 2;
+    uint16_t offset;
+    const char* label = labels_lookup(address, &offset);
+    if (!label || offset != 0) label = "";
+
+    const char* text = disassemble_word(word);
+    snprintf(lines[slot], LISTING_LINE_LENGTH, "%-16.16s %04X  %04X  %.*s",
+             label, address, word, (int)strcspn(text, "\n"), text);
+    line_words[slot] = word;
+    line_valid[slot] = 1;
+    format_count++;
+}
+
+const char* listing_line(const uint8_t memory[], uint16_t address) {
+    uint16_t slot = address / 2;
+    if (slot >= LISTING_WORDS) return "";
+    uint16_t word = memory_read_word((uint8_t*)memory, slot * 2);
+    if (!line_valid[slot] || line_words[slot] != word) format_line(slot, word);
+    return lines[slot];
+}
+
+void listing_invalidate_all(void) {
+    memset(line_valid, 0, sizeof(line_valid));
+}
+
+uint32_t listing_format_count(void) {
+    return format_count;
+}
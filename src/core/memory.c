@@ -1,4 +1,5 @@
 #include "idn16/memory.h"
+#include "idn16/video.h"
 #include "stdio.h"
 
 // Memory regions configuration
@@ -12,6 +13,21 @@ static const MemoryRegion memory_regions[REGION_COUNT] = {
     {SYSCALL_BASE, SYSCALL_END, true, "System Calls"},
 };
 
+// Pages written since the last memory_clear_dirty_pages
+static uint8_t dirty_pages[MEMORY_PAGES];
+
+static void mark_dirty(uint16_t first, uint16_t last) {
+    memset(dirty_pages + (first >> MEMORY_PAGE_SHIFT), 1, (last >> MEMORY_PAGE_SHIFT) - (first >> MEMORY_PAGE_SHIFT) + 1);
+}
+
+bool memory_page_dirty(uint8_t page) {
+    return dirty_pages[page];
+}
+
+void memory_clear_dirty_pages(void) {
+    memset(dirty_pages, 0, sizeof(dirty_pages));
+}
+
 static bool is_little_endian(void) {
     uint16_t value = 0x0001;
     return *((uint8_t*)&value);
@@ -28,12 +44,14 @@ bool load_user_rom(uint8_t memory[], FILE* rom) {
     size_t bytes_to_read = (file_size < max_read) ?  file_size : max_read;
     
     fread(memory + USER_ROM_START, 1, bytes_to_read, rom);
+    mark_dirty(USER_ROM_START, USER_ROM_END);
     return true;
 }
 
 void memory_init(uint8_t memory[]) {
     // Clear all memory
     memset(memory, 0, MEMORY_SIZE);
+    mark_dirty(0, MEMORY_SIZE - 1);
     
     // Initialize video system
     initialize_video_memory(memory);
@@ -41,6 +59,9 @@ void memory_init(uint8_t memory[]) {
     
     // Initialize audio system
     initialize_audio_system(memory);
+
+    // Rebuild renderer-side video state from the fresh memory image
+    video_state_reset(memory);
 }
 
 void initialize_video_memory(uint8_t memory[]) {
@@ -136,6 +157,10 @@ bool memory_write_byte(uint8_t memory[], uint16_t address, uint8_t data, bool pr
         return false;
     }
     memory[address] = data;
+    dirty_pages[address >> MEMORY_PAGE_SHIFT] = 1;
+    if (address >= VIDEO_RAM_START && address <= VIDEO_RAM_END) {
+        video_state_on_write(memory, address);
+    }
     return true;
 }
 
@@ -161,6 +186,61 @@ bool memory_write_word(uint8_t memory[], uint16_t address, uint16_t data, bool p
         memory[address ] = (uint8_t)(data >> 8);
         memory[address + 1] = (uint8_t)(data & 0x00FF);
     }
+    mark_dirty(address, address + 1);
+    if (address + 1 >= VIDEO_RAM_START && address <= VIDEO_RAM_END) {
+        video_state_on_write(memory, address);
+        video_state_on_write(memory, address + 1);
+    }
+    return true;
+}
+
+// Checks that address..address+length-1 is inside memory and writable
+static bool check_block_write(uint16_t address, uint16_t length, bool privileged) {
+    uint32_t last = (uint32_t)address + length - 1;
+    if (last >= MEMORY_SIZE) {
+        fprintf(stdout, "Error: Attempt to write block past end of memory.\n");
+        return false;
+    }
+
+    // Every region the block overlaps has to be writable
+    if (!privileged) {
+        for (int i = 0; i < REGION_COUNT; i++) {
+            const MemoryRegion* region = &memory_regions[i];
+            if (region->privileged && address <= region->end_address && last >= region->start_address) {
+                fprintf(stdout, "Error: Unprivaleged attempt to write block to privaleged memory. REGION: %s\n", region->name);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Marks a written block dirty and refreshes video state for the part inside video memory
+static void block_written(uint8_t memory[], uint16_t address, uint16_t length) {
+    uint32_t last = (uint32_t)address + length - 1;
+    mark_dirty(address, last);
+    if (last >= VIDEO_RAM_START && address <= VIDEO_RAM_END) {
+        uint16_t first_video = address > VIDEO_RAM_START ? address : VIDEO_RAM_START;
+        uint16_t last_video = last < VIDEO_RAM_END ? last : VIDEO_RAM_END;
+        video_state_on_write_range(memory, first_video, last_video);
+    }
+}
+
+bool memory_write_block(uint8_t memory[], uint16_t address, const uint8_t* data, uint16_t length, bool privileged) {
+    if (length == 0) return true;
+    if (!check_block_write(address, length, privileged)) return false;
+
+    memmove(memory + address, data, length);
+    block_written(memory, address, length);
+    return true;
+}
+
+bool memory_fill_block(uint8_t memory[], uint16_t address, uint8_t value, uint16_t length, bool privileged) {
+    if (length == 0) return true;
+    if (!check_block_write(address, length, privileged)) return false;
+
+    memset(memory + address, value, length);
+    block_written(memory, address, length);
     return true;
 }
 
@@ -173,6 +253,10 @@ MemoryRegion_t memory_get_region(uint16_t address) {
     return REGION_COUNT; // Invalid region
 }
 
+const char* memory_region_name(MemoryRegion_t region) {
+    return region < REGION_COUNT ? memory_regions[region].name : "Unmapped";
+}
+
 void memory_dump(uint8_t memory[], uint16_t start_addr, uint16_t bytes_per_line, uint16_t num_lines) {
     for (int line = 0; line < num_lines; line++) {
         uint16_t addr = start_addr + line * bytes_per_line;
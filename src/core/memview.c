@@ -0,0 +1,35 @@
+#include "idn16/memview.h"
+
+static uint8_t snapshot[MEMORY_SIZE];
+// Update number of each byte's last change; 0 if it has not changed since the reset
+static uint32_t changed_at[MEMORY_SIZE];
+static uint32_t update_count = 0;
+
+void memview_reset(const uint8_t memory[]) {
+    memcpy(snapshot, memory, MEMORY_SIZE);
+    memset(changed_at, 0, sizeof(changed_at));
+    update_count = 0;
+    memory_clear_dirty_pages();
+}
+
+int memview_update(const uint8_t memory[]) {
+    update_count++;
+    int changed = 0;
+    for (int page = 0; page < MEMORY_PAGES; page++) {
+        if (!memory_page_dirty(page)) continue;
+        int start = page << MEMORY_PAGE_SHIFT;
+        for (int address = start; address < start + MEMORY_PAGE_SIZE; address++) {
+            if (memory[address] != snapshot[address]) {
+                snapshot[address] = memory[address];
+                changed_at[address] = update_count;
+                changed++;
+            }
+        }
+    }
+    memory_clear_dirty_pages();
+    return changed;
+}
+
+bool memview_changed(uint16_t address) {
+    return changed_at[address] != 0 && update_count - changed_at[address] < MEMVIEW_HIGHLIGHT_FRAMES;
+}
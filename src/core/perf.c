@@ -0,0 +1,104 @@
+#include "idn16/perf.h"
+#include <inttypes.h>
+#include <string.h>
+
+static perf_frame_t ring[PERF_HISTORY];
+static uint32_t ring_next = 0;      // Total frames closed; the newest is at ring_next - 1
+
+static perf_frame_t current;
+static uint64_t frame_start_ns = 0;
+
+static FILE* log_file = NULL;
+
+static const char* phase_names[PERF_PHASES] = {
+    [PERF_CPU] = "cpu",
+    [PERF_RASTER] = "raster",
+    [PERF_UPLOAD] = "upload",
+    [PERF_UI] = "ui",
+    [PERF_PRESENT] = "present",
+};
+
+perf_frame_t* perf_current(void) {
+    return &current;
+}
+
+void perf_add_time(PerfPhase_t phase, uint64_t ns) {
+    current.phase_ns[phase] += ns;
+}
+
+void perf_end_frame(uint64_t now_ns) {
+    current.host_ns = frame_start_ns && now_ns > frame_start_ns ? now_ns - frame_start_ns : 0;
+    ring[ring_next++ & (PERF_HISTORY - 1)] = current;
+    if (log_file) perf_write_frame(log_file, &current);
+    perf_restart(now_ns);
+}
+
+void perf_restart(uint64_t now_ns) {
+    memset(&current, 0, sizeof(current));
+    frame_start_ns = now_ns;
+}
+
+void perf_clear(void) {
+    ring_next = 0;
+}
+
+int perf_last(perf_frame_t* out, int max) {
+    uint32_t available = ring_next < PERF_HISTORY ? ring_next : PERF_HISTORY;
+    int count = max < (int)available ? max : (int)available;
+    for (int i = 0; i < count; i++) {
+        out[i] = ring[(ring_next - count + i) & (PERF_HISTORY - 1)];
+    }
+    return count;
+}
+
+int perf_sum(int count, perf_frame_t* sum) {
+    memset(sum, 0, sizeof(*sum));
+    uint32_t available = ring_next < PERF_HISTORY ? ring_next : PERF_HISTORY;
+    if (count > (int)available) count = (int)available;
+    for (int i = 0; i < count; i++) {
+        const perf_frame_t* frame = &ring[(ring_next - count + i) & (PERF_HISTORY - 1)];
+        sum->host_ns += frame->host_ns;
+        for (int phase = 0; phase < PERF_PHASES; phase++) sum->phase_ns[phase] += frame->phase_ns[phase];
+        sum->guest_frames += frame->guest_frames;
+        sum->instructions += frame->instructions;
+        sum->syscalls += frame->syscalls;
+        sum->dirty_cells += frame->dirty_cells;
+        sum->audio_queued_bytes += frame->audio_queued_bytes;
+    }
+    return count;
+}
+
+const char* perf_phase_name(PerfPhase_t phase) {
+    return phase < PERF_PHASES ? phase_names[phase] : "?";
+}
+
+bool perf_log_open(const char* path) {
+    perf_log_close();
+    log_file = fopen(path, "w");
+    if (!log_file) {
+        fprintf(stderr, "Error: Unable to write performance log %s\n", path);
+        return false;
+    }
+    perf_write_header(log_file);
+    return true;
+}
+
+void perf_log_close(void) {
+    if (log_file) {
+        fclose(log_file);
+        log_file = NULL;
+    }
+}
+
+void perf_write_header(FILE* out) {
+    fprintf(out, "host_ns");
+    for (int phase = 0; phase < PERF_PHASES; phase++) fprintf(out, ",%s_ns", phase_names[phase]);
+    fprintf(out, ",guest_frames,instructions,syscalls,dirty_cells,audio_queued_bytes\n");
+}
+
+void perf_write_frame(FILE* out, const perf_frame_t* frame) {
+    fprintf(out, "%" PRIu64, frame->host_ns);
+    for (int phase = 0; phase < PERF_PHASES; phase++) fprintf(out, ",%" PRIu64, frame->phase_ns[phase]);
+    fprintf(out, ",%" PRIu32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n", frame->guest_frames,
+            frame->instructions, frame->syscalls, frame->dirty_cells, frame->audio_queued_bytes);
+}
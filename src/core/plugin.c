@@ -0,0 +1,185 @@
+#include "idn16/plugin.h"
+#include "idn16/syscall_table.h"
+#include "idn16/memory.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#define library_open(path) ((void*)LoadLibraryA(path))
+#define library_symbol(handle, name) ((void*)GetProcAddress((HMODULE)(handle), name))
+#define library_close(handle) FreeLibrary((HMODULE)(handle))
+#define library_error() "LoadLibrary failed"
+#else
+#include <dlfcn.h>
+#define library_open(path) dlopen(path, RTLD_NOW | RTLD_LOCAL)
+#define library_symbol(handle, name) dlsym(handle, name)
+#define library_close(handle) dlclose(handle)
+#define library_error() dlerror()
+#endif
+
+// A registered plugin handler; the syscall table passes it back as the handler context
+typedef struct {
+    idn16_syscall_fn fn;     // NULL while the slot is free
+    void* userdata;
+    uint16_t address;
+    int owner;               // Index into plugins[], or -1 for host-side handlers
+} plugin_syscall_t;
+
+typedef struct {
+    void* handle;
+    idn16_plugin_shutdown_fn shutdown;
+} plugin_t;
+
+static plugin_syscall_t plugin_syscalls[MAX_PLUGIN_SYSCALLS];
+static plugin_t plugins[MAX_PLUGINS];
+static int plugin_count = 0;
+
+// Plugin whose init function is running, so its registrations can be undone if init fails
+static int loading_plugin = -1;
+
+static Cpu_t* as_cpu(idn16_cpu_t* cpu) {
+    return (Cpu_t*)cpu;
+}
+
+static uint16_t host_get_reg(idn16_cpu_t* cpu, int reg) {
+    if (reg < 0 || reg > 7) return 0;
+    return as_cpu(cpu)->r[reg];
+}
+
+static void host_set_reg(idn16_cpu_t* cpu, int reg, uint16_t value) {
+    // r0 is hardwired to zero
+    if (reg < 1 || reg > 7) return;
+    as_cpu(cpu)->r[reg] = value;
+}
+
+static uint8_t host_read_byte(idn16_cpu_t* cpu, uint16_t address) {
+    return memory_read_byte(as_cpu(cpu)->memory, address);
+}
+
+static uint16_t host_read_word(idn16_cpu_t* cpu, uint16_t address) {
+    return memory_read_word(as_cpu(cpu)->memory, address);
+}
+
+static bool host_write_byte(idn16_cpu_t* cpu, uint16_t address, uint8_t value) {
+    return memory_write_byte(as_cpu(cpu)->memory, address, value, false);
+}
+
+static bool host_write_word(idn16_cpu_t* cpu, uint16_t address, uint16_t value) {
+    return memory_write_word(as_cpu(cpu)->memory, address, value, false);
+}
+
+static bool host_read_block(idn16_cpu_t* cpu, uint16_t address, void* dest, uint16_t length) {
+    if ((uint32_t)address + length > MEMORY_SIZE) return false;
+    memcpy(dest, as_cpu(cpu)->memory + address, length);
+    return true;
+}
+
+static bool host_write_block(idn16_cpu_t* cpu, uint16_t address, const void* src, uint16_t length) {
+    return memory_write_block(as_cpu(cpu)->memory, address, src, length, false);
+}
+
+static void host_charge_cycles(idn16_cpu_t* cpu, uint32_t cycles) {
+    as_cpu(cpu)->cycles += cycles;
+}
+
+static void call_plugin_syscall(Cpu_t* cpu, void* context) {
+    plugin_syscall_t* syscall = context;
+    syscall->fn((idn16_cpu_t*)cpu, syscall->userdata);
+}
+
+static bool host_register_syscall(uint16_t address, const char* name, uint8_t argc, uint16_t cycles,
+                                  idn16_syscall_fn handler, void* userdata) {
+    if (!handler) return false;
+    for (int i = 0; i < MAX_PLUGIN_SYSCALLS; i++) {
+        plugin_syscall_t* slot = &plugin_syscalls[i];
+        if (slot->fn) continue;
+        *slot = (plugin_syscall_t){ handler, userdata, address, loading_plugin };
+        // Plugins cannot know whether they touch video or audio memory, so no flags are set
+        if (!syscall_register(address, name, argc, 0, cycles, call_plugin_syscall, slot)) {
+            fprintf(stderr, "Error: Plugin syscall '%s' cannot use address 0x%04X\n", name ? name : "?", address);
+            slot->fn = NULL;
+            return false;
+        }
+        return true;
+    }
+    fprintf(stderr, "Error: Too many plugin syscalls (max %d)\n", MAX_PLUGIN_SYSCALLS);
+    return false;
+}
+
+static const idn16_host_api_t host_api = {
+    .api_version = IDN16_PLUGIN_API_VERSION,
+    .get_reg = host_get_reg,
+    .set_reg = host_set_reg,
+    .read_byte = host_read_byte,
+    .read_word = host_read_word,
+    .write_byte = host_write_byte,
+    .write_word = host_write_word,
+    .read_block = host_read_block,
+    .write_block = host_write_block,
+    .charge_cycles = host_charge_cycles,
+    .register_syscall = host_register_syscall,
+};
+
+const idn16_host_api_t* plugin_host_api(void) {
+    return &host_api;
+}
+
+static void unregister_owned_by(int owner) {
+    for (int i = 0; i < MAX_PLUGIN_SYSCALLS; i++) {
+        plugin_syscall_t* slot = &plugin_syscalls[i];
+        if (slot->fn && slot->owner == owner) {
+            syscall_unregister(slot->address);
+            slot->fn = NULL;
+        }
+    }
+}
+
+bool plugin_load(const char* path) {
+    if (plugin_count >= MAX_PLUGINS) {
+        fprintf(stderr, "Error: Too many plugins (max %d)\n", MAX_PLUGINS);
+        return false;
+    }
+    void* handle = library_open(path);
+    if (!handle) {
+        fprintf(stderr, "Error: Cannot load plugin %s: %s\n", path, library_error());
+        return false;
+    }
+
+    // Function pointers cannot be converted from void* directly in ISO C
+    idn16_plugin_init_fn init;
+    idn16_plugin_shutdown_fn shutdown;
+    void* symbol = library_symbol(handle, IDN16_PLUGIN_INIT_SYMBOL);
+    memcpy(&init, &symbol, sizeof(init));
+    symbol = library_symbol(handle, IDN16_PLUGIN_SHUTDOWN_SYMBOL);
+    memcpy(&shutdown, &symbol, sizeof(shutdown));
+    if (!init) {
+        fprintf(stderr, "Error: Plugin %s does not export %s\n", path, IDN16_PLUGIN_INIT_SYMBOL);
+        library_close(handle);
+        return false;
+    }
+
+    loading_plugin = plugin_count;
+    bool ok = init(&host_api);
+    loading_plugin = -1;
+    if (!ok) {
+        fprintf(stderr, "Error: Plugin %s failed to initialize\n", path);
+        unregister_owned_by(plugin_count);
+        library_close(handle);
+        return false;
+    }
+
+    plugins[plugin_count++] = (plugin_t){ handle, shutdown };
+    printf("Loaded plugin %s\n", path);
+    return true;
+}
+
+void plugin_unload_all(void) {
+    for (int i = plugin_count - 1; i >= 0; i--) {
+        if (plugins[i].shutdown) plugins[i].shutdown();
+        unregister_owned_by(i);
+        library_close(plugins[i].handle);
+    }
+    plugin_count = 0;
+    unregister_owned_by(-1);
+}
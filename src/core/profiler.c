@@ -0,0 +1,356 @@
+#include "idn16/profiler.h"
+#include "idn16/cpu_step.h"
+#include "idn16/instructions.h"
+#include "idn16/syscall_table.h"
+#include "idn16/labels.h"
+#include "idn16/trace.h"
+#include "idn16/coverage.h"
+#include "idn16/dasm.h"
+#include <stdlib.h>
+#include <string.h>
+
+static profile_t profile;
+static bool enabled = false;
+
+// Shadow call stack entry: the caller's node and where the call returns to
+typedef struct {
+    int caller;
+    uint16_t return_address;
+} call_frame_t;
+
+static call_node_t call_nodes[MAX_CALL_NODES];
+static int call_node_count = 0;
+static int current_node = 0;
+static call_frame_t call_stack[MAX_CALL_DEPTH];
+static int call_depth = 0;
+
+static const char* class_names[INSN_CLASS_COUNT] = {
+    "alu", "mul/div", "load", "store", "branch", "call/ret", "syscall", "other"
+};
+
+void profiler_enable(bool on) {
+    enabled = on;
+}
+
+bool profiler_enabled(void) {
+    return enabled;
+}
+
+static void reset_call_tree(void) {
+    call_nodes[0] = (call_node_t){ .address = USER_ROM_START, .parent = -1, .first_child = -1, .next_sibling = -1 };
+    call_node_count = 1;
+    current_node = 0;
+    call_depth = 0;
+}
+
+void profiler_reset(void) {
+    memset(&profile, 0, sizeof(profile));
+    reset_call_tree();
+}
+
+const profile_t* profiler_data(void) {
+    return &profile;
+}
+
+static InsnClass_t classify(const shared* i, const Cpu_t* cpu) {
+    switch (i->inst) {
+        case MUL: case MULH: case DIV: case MOD:
+            return INSN_CLASS_MULDIV;
+        case LDW: case LDB: case LDBP: case LDWP: case POPM:
+            return INSN_CLASS_LOAD;
+        case STW: case STB: case STBP: case STWP: case PUSHM:
+            return INSN_CLASS_STORE;
+        case JMP: case JEQ: case JNE: case JGT: case JLT:
+            return INSN_CLASS_BRANCH;
+        case JSR:
+            return cpu->r[i->first] >= SYSCALL_BASE ? INSN_CLASS_SYSCALL : INSN_CLASS_CALL;
+        case RET:
+            return INSN_CLASS_CALL;
+        case HLT: case NOP:
+            return INSN_CLASS_OTHER;
+        default:
+            return INSN_CLASS_ALU;
+    }
+}
+
+// Records the data access of a load or store before it executes, while the registers
+// still hold the address operands
+static void record_access(const shared* i, const Cpu_t* cpu) {
+    uint16_t address, length;
+    bool write;
+    if (!cpu_data_access(i, cpu, &address, &length, &write)) return;
+    // PUSHM and POPM count one access per register
+    uint64_t accesses = (i->inst == PUSHM || i->inst == POPM) ? length / 2 : 1;
+    uint64_t* counters = write ? profile.region_writes : profile.region_reads;
+    MemoryRegion_t region = memory_get_region(address);
+    if (region < REGION_COUNT) counters[region] += accesses;
+}
+
+const call_node_t* profiler_call_tree(int* count) {
+    if (call_node_count == 0) reset_call_tree();
+    *count = call_node_count;
+    return call_nodes;
+}
+
+// Finds or adds the child of parent for a call to address; parent itself if the tree is full
+static int call_child(int parent, uint16_t address, bool syscall) {
+    for (int child = call_nodes[parent].first_child; child >= 0; child = call_nodes[child].next_sibling) {
+        if (call_nodes[child].address == address && call_nodes[child].syscall == syscall) return child;
+    }
+    if (call_node_count >= MAX_CALL_NODES) return parent;
+    int child = call_node_count++;
+    call_nodes[child] = (call_node_t){ .address = address, .syscall = syscall, .parent = parent,
+                                       .first_child = -1, .next_sibling = call_nodes[parent].first_child };
+    call_nodes[parent].first_child = child;
+    return child;
+}
+
+// Attributes one executed instruction to the call tree. target is the JSR target register
+// value read before the instruction ran.
+static void record_call(const shared* i, uint16_t pc, uint16_t target, uint64_t cycles, const Cpu_t* cpu) {
+    if (call_node_count == 0) reset_call_tree();
+
+    if (i->inst == JSR && target >= SYSCALL_BASE) {
+        int leaf = call_child(current_node, target, true);
+        call_nodes[leaf].calls++;
+        call_nodes[leaf].exclusive += cycles;
+        return;
+    }
+
+    // The JSR belongs to the caller, the RET to the callee
+    call_nodes[current_node].exclusive += cycles;
+
+    if (i->inst == JSR) {
+        if (call_depth >= MAX_CALL_DEPTH) return;
+        call_stack[call_depth++] = (call_frame_t){ current_node, pc + 2 };
+        current_node = call_child(current_node, target, false);
+        call_nodes[current_node].calls++;
+    } else if (i->inst == RET) {
+        // Unwind to the frame this RET returns into; returns to anywhere else are ignored
+        for (int depth = call_depth - 1; depth >= 0; depth--) {
+            if (call_stack[depth].return_address == cpu->pc) {
+                current_node = call_stack[depth].caller;
+                call_depth = depth;
+                break;
+            }
+        }
+    }
+}
+
+void cpu_cycle_profiled(Cpu_t* cpu) {
+    uint64_t start = cpu->cycles;
+    cpu_step_t step;
+    if (!cpu_step_begin(cpu, &step)) return;
+    const shared* i = &step.i;
+    uint16_t pc = step.pc;
+    uint16_t target = i->inst == JSR ? cpu->r[i->first] : 0;
+    profile.class_count[classify(i, cpu)]++;
+    record_access(i, cpu);
+
+    cpu_step_end(cpu, &step);
+    if (coverage_enabled()) coverage_record(pc, step.inst, cpu->pc);
+
+    uint64_t cycles = cpu->cycles - start;
+    profile.instructions++;
+    profile.cycles += cycles;
+    profile.pc_count[pc >> 1]++;
+    profile.pc_cycles[pc >> 1] += cycles;
+    record_call(i, pc, target, cycles, cpu);
+}
+
+// qsort comparators over slot or label indices, most cycles first
+static const uint64_t* sort_cycles;
+
+static int compare_cycles(const void* a, const void* b) {
+    uint64_t cycles_a = sort_cycles[*(const int*)a];
+    uint64_t cycles_b = sort_cycles[*(const int*)b];
+    return (cycles_a < cycles_b) - (cycles_a > cycles_b);
+}
+
+static double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+static void print_labels(FILE* out, int max_rows) {
+    // One extra bucket for code before the first label
+    static uint64_t label_cycles[MAX_LABELS + 1];
+    static uint64_t label_counts[MAX_LABELS + 1];
+    static int order[MAX_LABELS + 1];
+    memset(label_cycles, 0, sizeof(label_cycles));
+    memset(label_counts, 0, sizeof(label_counts));
+
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++) {
+        if (profile.pc_count[slot] == 0) continue;
+        int bucket = labels_index(slot * 2) + 1;
+        label_cycles[bucket] += profile.pc_cycles[slot];
+        label_counts[bucket] += profile.pc_count[slot];
+    }
+    int count = 0;
+    for (int i = 0; i <= labels_count(); i++) {
+        if (label_counts[i] > 0) order[count++] = i;
+    }
+    sort_cycles = label_cycles;
+    qsort(order, count, sizeof(order[0]), compare_cycles);
+
+    fprintf(out, "\n%-24s %12s %12s %7s\n", "label", "instructions", "cycles", "%");
+    for (int i = 0; i < count && i < max_rows; i++) {
+        int bucket = order[i];
+        fprintf(out, "%-24s %12llu %12llu %6.2f%%\n", bucket ? labels_name(bucket - 1) : "(no label)",
+                (unsigned long long)label_counts[bucket], (unsigned long long)label_cycles[bucket],
+                percent(label_cycles[bucket], profile.cycles));
+    }
+}
+
+void profiler_update_inclusive(void) {
+    // Children are always added after their parent, so one backwards pass sums every subtree
+    for (int n = 0; n < call_node_count; n++) {
+        call_nodes[n].inclusive = call_nodes[n].exclusive;
+    }
+    for (int n = call_node_count - 1; n > 0; n--) {
+        call_nodes[call_nodes[n].parent].inclusive += call_nodes[n].inclusive;
+    }
+}
+
+// Frame name for a call tree node: syscall name, label or address
+static void call_node_name(const call_node_t* node, char* name, size_t size) {
+    if (node->syscall) {
+        const syscall_info_t* info = syscall_info(node->address);
+        if (info) {
+            snprintf(name, size, "%s", info->name);
+            return;
+        }
+    }
+    uint16_t offset;
+    const char* label = labels_lookup(node->address, &offset);
+    if (label && offset == 0) {
+        snprintf(name, size, "%s", label);
+    } else if (label) {
+        snprintf(name, size, "%s+%u", label, offset);
+    } else {
+        snprintf(name, size, "0x%04X", node->address);
+    }
+}
+
+static bool called_from_itself(int n) {
+    for (int up = call_nodes[n].parent; up >= 0; up = call_nodes[up].parent) {
+        if (call_nodes[up].address == call_nodes[n].address && call_nodes[up].syscall == call_nodes[n].syscall) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void print_call_targets(FILE* out, int max_rows) {
+    // Merge the call paths of each target; recursive calls count towards inclusive cycles once
+    typedef struct {
+        uint16_t address;
+        bool syscall;
+        uint64_t calls, inclusive, exclusive;
+    } call_target_t;
+    static call_target_t targets[MAX_CALL_NODES];
+    static uint64_t target_inclusive[MAX_CALL_NODES];
+    static int order[MAX_CALL_NODES];
+    static int target_index[2][MEMORY_SIZE];  // By syscall flag and address, -1 if not seen yet
+    int count = 0;
+
+    memset(target_index, -1, sizeof(target_index));
+    profiler_update_inclusive();
+    for (int n = 1; n < call_node_count; n++) {
+        const call_node_t* node = &call_nodes[n];
+        int* t_slot = &target_index[node->syscall][node->address];
+        if (*t_slot < 0) {
+            *t_slot = count;
+            targets[count++] = (call_target_t){ node->address, node->syscall, 0, 0, 0 };
+        }
+        int t = *t_slot;
+        targets[t].calls += node->calls;
+        targets[t].exclusive += node->exclusive;
+        if (!called_from_itself(n)) targets[t].inclusive += node->inclusive;
+    }
+    for (int t = 0; t < count; t++) {
+        target_inclusive[t] = targets[t].inclusive;
+        order[t] = t;
+    }
+    sort_cycles = target_inclusive;
+    qsort(order, count, sizeof(order[0]), compare_cycles);
+
+    fprintf(out, "\n%-24s %10s %12s %12s %7s\n", "call target", "calls", "inclusive", "exclusive", "incl %");
+    for (int i = 0; i < count && i < max_rows; i++) {
+        const call_target_t* t = &targets[order[i]];
+        char name[LABEL_NAME_LENGTH + 16];
+        call_node_name(&(call_node_t){ .address = t->address, .syscall = t->syscall }, name, sizeof(name));
+        fprintf(out, "%-24s %10llu %12llu %12llu %6.2f%%\n", name, (unsigned long long)t->calls,
+                (unsigned long long)t->inclusive, (unsigned long long)t->exclusive, percent(t->inclusive, profile.cycles));
+    }
+}
+
+bool profiler_write_collapsed(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Unable to write call stacks to %s\n", path);
+        return false;
+    }
+    if (call_node_count == 0) reset_call_tree();
+
+    int path_nodes[MAX_CALL_DEPTH + 2];
+    for (int n = 0; n < call_node_count; n++) {
+        if (call_nodes[n].exclusive == 0) continue;
+        int depth = 0;
+        for (int up = n; up >= 0 && depth < MAX_CALL_DEPTH + 2; up = call_nodes[up].parent) {
+            path_nodes[depth++] = up;
+        }
+        while (depth > 0) {
+            char name[LABEL_NAME_LENGTH + 16];
+            call_node_name(&call_nodes[path_nodes[--depth]], name, sizeof(name));
+            fprintf(out, "%s%c", name, depth > 0 ? ';' : ' ');
+        }
+        fprintf(out, "%llu\n", (unsigned long long)call_nodes[n].exclusive);
+    }
+    fclose(out);
+    return true;
+}
+
+void profiler_print_report(FILE* out, const Cpu_t* cpu, int max_rows) {
+    fprintf(out, "Profile: %llu instructions, %llu cycles\n",
+            (unsigned long long)profile.instructions, (unsigned long long)profile.cycles);
+
+    fprintf(out, "\n%-10s %12s %7s\n", "class", "count", "%");
+    for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+        fprintf(out, "%-10s %12llu %6.2f%%\n", class_names[c], (unsigned long long)profile.class_count[c],
+                percent(profile.class_count[c], profile.instructions));
+    }
+
+    fprintf(out, "\n%-16s %12s %12s\n", "region", "reads", "writes");
+    for (int r = 0; r < REGION_COUNT; r++) {
+        if (profile.region_reads[r] == 0 && profile.region_writes[r] == 0) continue;
+        fprintf(out, "%-16s %12llu %12llu\n", memory_region_name((MemoryRegion_t)r),
+                (unsigned long long)profile.region_reads[r], (unsigned long long)profile.region_writes[r]);
+    }
+
+    static int order[PROFILE_SLOTS];
+    int count = 0;
+    for (int slot = 0; slot < PROFILE_SLOTS; slot++) {
+        if (profile.pc_count[slot] > 0) order[count++] = slot;
+    }
+    sort_cycles = profile.pc_cycles;
+    qsort(order, count, sizeof(order[0]), compare_cycles);
+
+    fprintf(out, "\n%-6s %-24s %12s %12s %7s  %s\n", "pc", "location", "count", "cycles", "%", "instruction");
+    for (int i = 0; i < count && i < max_rows; i++) {
+        uint16_t pc = order[i] * 2;
+        char location[32] = "";
+        uint16_t offset;
+        const char* label = labels_lookup(pc, &offset);
+        if (label) snprintf(location, sizeof(location), "%s+%u", label, offset);
+        const char* text = disassemble_word(memory_read_word((uint8_t*)cpu->memory, pc));
+        fprintf(out, "0x%04X %-24s %12llu %12llu %6.2f%%  %.*s\n", pc, location,
+                (unsigned long long)profile.pc_count[order[i]], (unsigned long long)profile.pc_cycles[order[i]],
+                percent(profile.pc_cycles[order[i]], profile.cycles), (int)strcspn(text, "\n"), text);
+    }
+
+    if (labels_count() > 0) print_labels(out, max_rows);
+    print_call_targets(out, max_rows);
+
+    fprintf(out, "\n");
+    syscall_stats_print(out);
+}
@@ -0,0 +1,159 @@
+#define _POSIX_C_SOURCE 199309L
+#include "idn16/syscall_table.h"
+#include "idn16/memory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Names match the SYSCALL_ address macros in memory.h.
+// The block memory syscalls pay their base cost here and their per-byte cost themselves.
+static syscall_info_t syscall_table[SYSCALL_TABLE_SIZE] = {
+    [SYSCALL_CLEAR_SCREEN - SYSCALL_BASE]       = { .name = "CLEAR_SCREEN",       .handler = syscall_clear_screen,          .argc = 0, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_PUT_CHAR - SYSCALL_BASE]           = { .name = "PUT_CHAR",           .handler = syscall_put_char,              .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_PUT_STRING - SYSCALL_BASE]         = { .name = "PUT_STRING",         .handler = syscall_put_string,            .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_CURSOR - SYSCALL_BASE]         = { .name = "SET_CURSOR",         .handler = syscall_set_cursor,            .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_GET_CURSOR - SYSCALL_BASE]         = { .name = "GET_CURSOR",         .handler = syscall_get_cursor,            .argc = 0, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_PUT_CHAR_AT - SYSCALL_BASE]        = { .name = "PUT_CHAR_AT",        .handler = syscall_put_char_at,           .argc = 3, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SCROLL_UP - SYSCALL_BASE]          = { .name = "SCROLL_UP",          .handler = syscall_scroll_up,             .argc = 0, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_FILL_AREA - SYSCALL_BASE]          = { .name = "FILL_AREA",          .handler = syscall_fill_area,             .argc = 5, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_TEXT_COLOR - SYSCALL_BASE]     = { .name = "SET_TEXT_COLOR",     .handler = syscall_set_text_color,        .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_GET_INPUT - SYSCALL_BASE]          = { .name = "GET_INPUT",          .handler = syscall_get_input,             .argc = 1, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_PLAY_TONE_CHANNEL - SYSCALL_BASE]  = { .name = "PLAY_TONE_CHANNEL",  .handler = syscall_play_tone_channel,     .argc = 4, .flags = SYSCALL_TOUCHES_AUDIO, .cycles = 0 },
+    [SYSCALL_MULTIPLY - SYSCALL_BASE]           = { .name = "MULTIPLY",           .handler = syscall_multiply,              .argc = 2, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_DIVIDE - SYSCALL_BASE]             = { .name = "DIVIDE",             .handler = syscall_divide,                .argc = 2, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_RANDOM - SYSCALL_BASE]             = { .name = "RANDOM",             .handler = syscall_random,                .argc = 0, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_MEMCPY - SYSCALL_BASE]             = { .name = "MEMCPY",             .handler = syscall_memcpy,                .argc = 3, .flags = 0,                     .cycles = BLOCK_SYSCALL_BASE_CYCLES },
+    [SYSCALL_PRINT_HEX - SYSCALL_BASE]          = { .name = "PRINT_HEX",          .handler = syscall_print_hex,             .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_PRINT_DEC - SYSCALL_BASE]          = { .name = "PRINT_DEC",          .handler = syscall_print_dec,             .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_SPRITE - SYSCALL_BASE]         = { .name = "SET_SPRITE",         .handler = syscall_set_sprite,            .argc = 4, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_PALETTE - SYSCALL_BASE]        = { .name = "SET_PALETTE",        .handler = syscall_set_palette,           .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_MOVE_SPRITE - SYSCALL_BASE]        = { .name = "MOVE_SPRITE",        .handler = syscall_move_sprite,           .argc = 3, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_TILE_PIXEL - SYSCALL_BASE]     = { .name = "SET_TILE_PIXEL",     .handler = syscall_set_tile_pixel,        .argc = 4, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_GET_FRAME_COUNT - SYSCALL_BASE]    = { .name = "GET_FRAME_COUNT",    .handler = syscall_get_frame_count,       .argc = 0, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_HIDE_SPRITE - SYSCALL_BASE]        = { .name = "HIDE_SPRITE",        .handler = syscall_hide_sprite,           .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_GET_SPRITE_POS - SYSCALL_BASE]     = { .name = "GET_SPRITE_POS",     .handler = syscall_get_sprite_pos,        .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_CLEAR_SPRITE_RANGE - SYSCALL_BASE] = { .name = "CLEAR_SPRITE_RANGE", .handler = syscall_clear_sprite_range,    .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_CHECK_COLLISION - SYSCALL_BASE]    = { .name = "CHECK_COLLISION",    .handler = syscall_check_collision,       .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SHIFT_SPRITES - SYSCALL_BASE]      = { .name = "SHIFT_SPRITES",      .handler = syscall_shift_sprites,         .argc = 4, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_COPY_SPRITE - SYSCALL_BASE]        = { .name = "COPY_SPRITE",        .handler = syscall_copy_sprite,           .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_SET_RETURN_ADDR - SYSCALL_BASE]    = { .name = "SET_RETURN_ADDR",    .handler = syscall_set_return_addr,       .argc = 0, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_MOVE_SPRITE_RIGHT - SYSCALL_BASE]  = { .name = "MOVE_SPRITE_RIGHT",  .handler = syscall_move_sprite_right,     .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_MOVE_SPRITE_LEFT - SYSCALL_BASE]   = { .name = "MOVE_SPRITE_LEFT",   .handler = syscall_move_sprite_left,      .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_MOVE_SPRITE_UP - SYSCALL_BASE]     = { .name = "MOVE_SPRITE_UP",     .handler = syscall_move_sprite_up,        .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_MOVE_SPRITE_DOWN - SYSCALL_BASE]   = { .name = "MOVE_SPRITE_DOWN",   .handler = syscall_move_sprite_down,      .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_TIMER_START - SYSCALL_BASE]        = { .name = "TIMER_START",        .handler = syscall_timer_start,           .argc = 1, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_TIMER_QUERY - SYSCALL_BASE]        = { .name = "TIMER_QUERY",        .handler = syscall_timer_query,           .argc = 1, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_SLEEP - SYSCALL_BASE]              = { .name = "SLEEP",              .handler = syscall_sleep,                 .argc = 1, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_NUMBER_TO_STRING - SYSCALL_BASE]   = { .name = "NUMBER_TO_STRING",   .handler = syscall_number_to_string,      .argc = 4, .flags = 0,                     .cycles = 0 },
+    [SYSCALL_STOP_CHANNEL - SYSCALL_BASE]       = { .name = "STOP_CHANNEL",       .handler = syscall_stop_channel,          .argc = 1, .flags = SYSCALL_TOUCHES_AUDIO, .cycles = 0 },
+    [SYSCALL_SET_MASTER_VOLUME - SYSCALL_BASE]  = { .name = "SET_MASTER_VOLUME",  .handler = syscall_set_master_volume,     .argc = 1, .flags = SYSCALL_TOUCHES_AUDIO, .cycles = 0 },
+    [SYSCALL_STOP_ALL_AUDIO - SYSCALL_BASE]     = { .name = "STOP_ALL_AUDIO",     .handler = syscall_stop_all_audio,        .argc = 0, .flags = SYSCALL_TOUCHES_AUDIO, .cycles = 0 },
+    [SYSCALL_UPDATE_SPRITES - SYSCALL_BASE]     = { .name = "UPDATE_SPRITES",     .handler = syscall_update_sprites,        .argc = 2, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_LOAD_TILES - SYSCALL_BASE]         = { .name = "LOAD_TILES",         .handler = syscall_load_tiles,            .argc = 3, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_LOAD_PALETTE - SYSCALL_BASE]       = { .name = "LOAD_PALETTE",       .handler = syscall_load_palette,          .argc = 1, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_COLLIDE_SPRITES - SYSCALL_BASE]    = { .name = "COLLIDE_SPRITES",    .handler = syscall_collide_sprites,       .argc = 6, .flags = SYSCALL_TOUCHES_VIDEO, .cycles = 0 },
+    [SYSCALL_MEMSET - SYSCALL_BASE]             = { .name = "MEMSET",             .handler = syscall_memset,                .argc = 3, .flags = 0,                     .cycles = BLOCK_SYSCALL_BASE_CYCLES },
+    [SYSCALL_MEMCMP - SYSCALL_BASE]             = { .name = "MEMCMP",             .handler = syscall_memcmp,                .argc = 3, .flags = 0,                     .cycles = BLOCK_SYSCALL_BASE_CYCLES },
+    [SYSCALL_MEMCHR - SYSCALL_BASE]             = { .name = "MEMCHR",             .handler = syscall_memchr,                .argc = 3, .flags = 0,                     .cycles = BLOCK_SYSCALL_BASE_CYCLES },
+    [SYSCALL_STRLEN - SYSCALL_BASE]             = { .name = "STRLEN",             .handler = syscall_strlen,                .argc = 2, .flags = 0,                     .cycles = BLOCK_SYSCALL_BASE_CYCLES },
+};
+
+static syscall_stats_t stats[SYSCALL_TABLE_SIZE];
+static uint64_t total_calls = 0;
+
+static uint64_t host_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static bool slot_in_use(uint16_t index) {
+    return syscall_table[index].handler || syscall_table[index].context_handler;
+}
+
+void handle_system_call(uint16_t address, Cpu_t* cpu) {
+    uint16_t index = address - SYSCALL_BASE;
+    if (address < SYSCALL_BASE || !slot_in_use(index)) {
+        fprintf(stderr, "Unknown system call: 0x%04X\n", address);
+        return;
+    }
+    const syscall_info_t* entry = &syscall_table[index];
+    uint64_t cycles_before = cpu->cycles;
+    uint64_t start = host_time_ns();
+    if (entry->handler) {
+        entry->handler(cpu);
+    } else {
+        entry->context_handler(cpu, entry->context);
+    }
+    stats[index].host_ns += host_time_ns() - start;
+    cpu->cycles += entry->cycles;
+    stats[index].guest_cycles += cpu->cycles - cycles_before;
+    stats[index].calls++;
+    total_calls++;
+}
+
+uint64_t syscall_total_calls(void) {
+    return total_calls;
+}
+
+const syscall_info_t* syscall_info(uint16_t address) {
+    if (address < SYSCALL_BASE || !slot_in_use(address - SYSCALL_BASE)) return NULL;
+    return &syscall_table[address - SYSCALL_BASE];
+}
+
+bool syscall_register(uint16_t address, const char* name, uint8_t argc, uint8_t flags, uint16_t cycles,
+                      syscall_context_handler_t handler, void* context) {
+    if (address < SYSCALL_BASE || !handler || !name) return false;
+    uint16_t index = address - SYSCALL_BASE;
+    if (slot_in_use(index)) return false;
+    syscall_table[index] = (syscall_info_t){
+        .name = name,
+        .context_handler = handler,
+        .context = context,
+        .argc = argc,
+        .flags = flags,
+        .cycles = cycles,
+    };
+    memset(&stats[index], 0, sizeof(stats[index]));
+    return true;
+}
+
+void syscall_unregister(uint16_t address) {
+    if (address < SYSCALL_BASE) return;
+    uint16_t index = address - SYSCALL_BASE;
+    if (syscall_table[index].handler) return;
+    memset(&syscall_table[index], 0, sizeof(syscall_table[index]));
+}
+
+const syscall_stats_t* syscall_stats(uint16_t address) {
+    if (address < SYSCALL_BASE) return NULL;
+    return &stats[address - SYSCALL_BASE];
+}
+
+void syscall_stats_reset(void) {
+    memset(stats, 0, sizeof(stats));
+}
+
+static int compare_host_time(const void* a, const void* b) {
+    uint64_t time_a = stats[*(const uint16_t*)a].host_ns;
+    uint64_t time_b = stats[*(const uint16_t*)b].host_ns;
+    return (time_a < time_b) - (time_a > time_b);
+}
+
+void syscall_stats_print(FILE* out) {
+    uint16_t order[SYSCALL_TABLE_SIZE];
+    int count = 0;
+    for (uint16_t i = 0; i < SYSCALL_TABLE_SIZE; i++) {
+        if (stats[i].calls > 0) order[count++] = i;
+    }
+    qsort(order, count, sizeof(order[0]), compare_host_time);
+
+    fprintf(out, "%-6s %-20s %10s %12s %12s %10s\n", "addr", "syscall", "calls", "cycles", "host_us", "ns/call");
+    for (int i = 0; i < count; i++) {
+        const syscall_stats_t* s = &stats[order[i]];
+        fprintf(out, "0x%04X %-20s %10llu %12llu %12.1f %10llu\n",
+                SYSCALL_BASE + order[i], syscall_table[order[i]].name,
+                (unsigned long long)s->calls, (unsigned long long)s->guest_cycles,
+                s->host_ns / 1000.0, (unsigned long long)(s->host_ns / s->calls));
+    }
+}
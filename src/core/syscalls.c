@@ -1,9 +1,21 @@
 #include "idn16/cpu.h"
 #include "idn16/memory.h"
+#include "idn16/timing.h"
+#include "idn16/video.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+// Address of the character cell shown at screen position (x, y).
+// The character buffer is a ring: the scroll registers say which cell is drawn at the top left.
+static uint16_t char_cell_address(Cpu_t* cpu, uint16_t x, uint16_t y) {
+    uint16_t scroll_x = memory_read_word(cpu->memory, TEXT_SCROLL_X_REG) % SCREEN_WIDTH_TILES;
+    uint16_t scroll_y = memory_read_word(cpu->memory, TEXT_SCROLL_Y_REG) % SCREEN_HEIGHT_TILES;
+    uint16_t column = (x + scroll_x) % SCREEN_WIDTH_TILES;
+    uint16_t row = (y + scroll_y) % SCREEN_HEIGHT_TILES;
+    return CHAR_BUFFER_START + (row * SCREEN_WIDTH_TILES) + column;
+}
+
 void syscall_clear_screen(Cpu_t* cpu) {
     // Clear tile buffer with space characters
     bool success;
@@ -11,9 +23,11 @@ void syscall_clear_screen(Cpu_t* cpu) {
         success |= memory_write_byte(cpu->memory, CHAR_BUFFER_START + i, 32, true); // 32 = space character
     }
     
-    // Reset cursor position
+    // Reset cursor position and scroll
     success |= memory_write_word(cpu->memory, CURSOR_X_REG, 0, true);
     success |= memory_write_word(cpu->memory, CURSOR_Y_REG, 0, true);
+    success |= memory_write_word(cpu->memory, TEXT_SCROLL_X_REG, 0, true);
+    success |= memory_write_word(cpu->memory, TEXT_SCROLL_Y_REG, 0, true);
     
     cpu->r[1] = success;
 }
@@ -30,7 +44,7 @@ void syscall_put_char(Cpu_t* cpu) {
     } else {
         // Write character to tile buffer
         if (cursor_x < SCREEN_WIDTH_TILES && cursor_y < SCREEN_HEIGHT_TILES) {
-            uint16_t tile_addr = CHAR_BUFFER_START + (cursor_y * SCREEN_WIDTH_TILES) + cursor_x;
+            uint16_t tile_addr = char_cell_address(cpu, cursor_x, cursor_y);
             success |=  memory_write_byte(cpu->memory, tile_addr, character, true);
             cursor_x++;
         }
@@ -169,17 +183,91 @@ void syscall_random(Cpu_t* cpu) {
     cpu->r[1] = value;
 }
 
+// Charges a block memory syscall for touching length bytes.
+// The base cost is charged by the syscall table on every call.
+static void charge_block_cycles(Cpu_t* cpu, uint32_t length) {
+    cpu->cycles += (length + BLOCK_SYSCALL_BYTES_PER_CYCLE - 1) / BLOCK_SYSCALL_BYTES_PER_CYCLE;
+}
+
+// True if address..address+length-1 is inside memory
+static bool block_in_memory(uint16_t address, uint16_t length) {
+    return (uint32_t)address + length <= MEMORY_SIZE;
+}
+
 void syscall_memcpy(Cpu_t* cpu) {
     uint16_t dest_addr = cpu->r[1];
     uint16_t src_addr = cpu->r[2];
     uint16_t length = cpu->r[3];
     
-    for (uint16_t i = 0; i < length; i++) {
-        uint8_t byte = memory_read_byte(cpu->memory, src_addr + i);
-        memory_write_byte(cpu->memory, dest_addr + i, byte, false);
-    }
+    // One range and permission check, then a single overlap-safe copy
+    bool success = block_in_memory(src_addr, length) &&
+                   memory_write_block(cpu->memory, dest_addr, cpu->memory + src_addr, length, false);
+    charge_block_cycles(cpu, length);
     
-    cpu->r[1] = length; // Return bytes copied
+    cpu->r[1] = success ? length : 0; // Return bytes copied
+}
+
+void syscall_memset(Cpu_t* cpu) {
+    uint16_t dest_addr = cpu->r[1];
+    uint8_t value = cpu->r[2] & 0xFF;
+    uint16_t length = cpu->r[3];
+
+    bool success = memory_fill_block(cpu->memory, dest_addr, value, length, false);
+    charge_block_cycles(cpu, length);
+
+    cpu->r[1] = success ? length : 0; // Return bytes set
+}
+
+void syscall_memcmp(Cpu_t* cpu) {
+    uint16_t a_addr = cpu->r[1];
+    uint16_t b_addr = cpu->r[2];
+    uint16_t length = cpu->r[3];
+
+    if (!block_in_memory(a_addr, length) || !block_in_memory(b_addr, length)) {
+        cpu->r[1] = 0;
+        cpu->r[2] = 1; // Error: range out of memory
+        return;
+    }
+
+    int result = memcmp(cpu->memory + a_addr, cpu->memory + b_addr, length);
+    charge_block_cycles(cpu, length);
+
+    cpu->r[1] = (uint16_t)(result < 0 ? -1 : (result > 0 ? 1 : 0)); // -1, 0 or 1
+    cpu->r[2] = 0;
+}
+
+void syscall_memchr(Cpu_t* cpu) {
+    uint16_t addr = cpu->r[1];
+    uint8_t value = cpu->r[2] & 0xFF;
+    uint16_t length = cpu->r[3];
+
+    if (!block_in_memory(addr, length)) {
+        cpu->r[1] = 0;
+        cpu->r[2] = 0; // Not found (range out of memory)
+        return;
+    }
+
+    const uint8_t* found = memchr(cpu->memory + addr, value, length);
+    // Only the bytes up to the match are scanned
+    charge_block_cycles(cpu, found ? (uint32_t)(found - (cpu->memory + addr)) + 1 : length);
+
+    cpu->r[1] = found ? (uint16_t)(found - cpu->memory) : 0; // Address of the match
+    cpu->r[2] = found != NULL;                                // Found (1/0)
+}
+
+void syscall_strlen(Cpu_t* cpu) {
+    uint16_t addr = cpu->r[1];
+    uint16_t max_length = cpu->r[2];
+
+    // Never scan past the end of memory
+    uint32_t limit = MEMORY_SIZE - addr;
+    if (max_length < limit) limit = max_length;
+
+    const uint8_t* end = memchr(cpu->memory + addr, 0, limit);
+    uint16_t length = end ? (uint16_t)(end - (cpu->memory + addr)) : (uint16_t)limit;
+    charge_block_cycles(cpu, length + 1);
+
+    cpu->r[1] = length; // Length excluding the terminator, or the limit if none was found
 }
 
 // Additional 8x8 font system calls
@@ -206,26 +294,20 @@ void syscall_put_char_at(Cpu_t* cpu) {
     uint8_t character = cpu->r[3] & 0xFF;
     
     if (x < SCREEN_WIDTH_TILES && y < SCREEN_HEIGHT_TILES) {
-        uint16_t tile_addr = CHAR_BUFFER_START + (y * SCREEN_WIDTH_TILES) + x;
+        uint16_t tile_addr = char_cell_address(cpu, x, y);
         memory_write_byte(cpu->memory, tile_addr, character, true);
     }
 }
 
 void syscall_scroll_up(Cpu_t* cpu) {
-    // Move all lines up by one
-    for (uint16_t y = 0; y < SCREEN_HEIGHT_TILES - 1; y++) {
-        for (uint16_t x = 0; x < SCREEN_WIDTH_TILES; x++) {
-            uint16_t src_addr = CHAR_BUFFER_START + ((y + 1) * SCREEN_WIDTH_TILES) + x;
-            uint16_t dest_addr = CHAR_BUFFER_START + (y * SCREEN_WIDTH_TILES) + x;
-            uint8_t character = memory_read_byte(cpu->memory, src_addr);
-            memory_write_byte(cpu->memory, dest_addr, character, true);
-        }
-    }
+    // Move the top of the ring down one row instead of copying the buffer;
+    // the old top row becomes the new bottom row
+    uint16_t scroll_y = memory_read_word(cpu->memory, TEXT_SCROLL_Y_REG) % SCREEN_HEIGHT_TILES;
+    memory_write_word(cpu->memory, TEXT_SCROLL_Y_REG, (scroll_y + 1) % SCREEN_HEIGHT_TILES, true);
     
     // Clear the last line
     for (uint16_t x = 0; x < SCREEN_WIDTH_TILES; x++) {
-        uint16_t addr = CHAR_BUFFER_START + ((SCREEN_HEIGHT_TILES - 1) * SCREEN_WIDTH_TILES) + x;
-        memory_write_byte(cpu->memory, addr, ' ', true);
+        memory_write_byte(cpu->memory, char_cell_address(cpu, x, SCREEN_HEIGHT_TILES - 1), ' ', true);
     }
 }
 
@@ -238,7 +320,7 @@ void syscall_fill_area(Cpu_t* cpu) {
     
     for (uint16_t row = 0; row < height && (y + row) < SCREEN_HEIGHT_TILES; row++) {
         for (uint16_t col = 0; col < width && (x + col) < SCREEN_WIDTH_TILES; col++) {
-            uint16_t addr = CHAR_BUFFER_START + ((y + row) * SCREEN_WIDTH_TILES) + (x + col);
+            uint16_t addr = char_cell_address(cpu, x + col, y + row);
             memory_write_byte(cpu->memory, addr, character, true);
         }
     }
@@ -249,8 +331,8 @@ void syscall_set_text_color(Cpu_t* cpu) {
     uint16_t bg_color = cpu->r[2];
     
     // Store colors in unused video control registers for future use
-    memory_write_word(cpu->memory, VIDEO_CONTROL_START + 10, fg_color, true);
-    memory_write_word(cpu->memory, VIDEO_CONTROL_START + 12, bg_color, true);
+    memory_write_word(cpu->memory, TEXT_FG_COLOR_REG, fg_color, true);
+    memory_write_word(cpu->memory, TEXT_BG_COLOR_REG, bg_color, true);
 }
 
 void syscall_print_hex(Cpu_t* cpu) {
@@ -280,7 +362,7 @@ void syscall_print_dec(Cpu_t* cpu) {
 }
 
 void syscall_set_sprite(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t x = cpu->r[2] & 0xFF;
     uint8_t y = cpu->r[3] & 0xFF;
     uint8_t tile_id = cpu->r[4] & 0xFF;
@@ -322,7 +404,7 @@ void syscall_set_palette(Cpu_t* cpu) {
 }
 
 void syscall_move_sprite(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t new_x = cpu->r[2] & 0xFF;
     uint8_t new_y = cpu->r[3] & 0xFF;
     
@@ -382,7 +464,7 @@ void syscall_get_frame_count(Cpu_t* cpu) {
 }
 
 void syscall_hide_sprite(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     
     if (sprite_id >= MAX_SPRITES) {
         cpu->r[1] = 0; // Error: invalid sprite ID
@@ -397,7 +479,7 @@ void syscall_hide_sprite(Cpu_t* cpu) {
 }
 
 void syscall_get_sprite_pos(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     
     if (sprite_id >= MAX_SPRITES) {
         cpu->r[1] = 0; // Error: invalid sprite ID
@@ -418,16 +500,16 @@ void syscall_get_sprite_pos(Cpu_t* cpu) {
 }
 
 void syscall_clear_sprite_range(Cpu_t* cpu) {
-    uint8_t start_id = cpu->r[1] & 0xFF;
-    uint8_t end_id = cpu->r[2] & 0xFF;
+    uint16_t start_id = cpu->r[1];
+    uint16_t end_id = cpu->r[2];
     
     if (start_id >= MAX_SPRITES || end_id >= MAX_SPRITES || start_id > end_id) {
         cpu->r[1] = 0; // Error: invalid sprite range
         return;
     }
     
-    // Clear sprites in range by disabling them (tile_id = 0)
-    for (uint8_t id = start_id; id <= end_id; id++) {
+    // Clear sprites in range by disabling them (tile_id = 0); inactive ones already are
+    for (uint16_t id = video_next_active_sprite(start_id); id <= end_id; id = video_next_active_sprite(id + 1)) {
         uint16_t sprite_addr = SPRITE_TABLE_START + (id * 3);
         memory_write_byte(cpu->memory, sprite_addr + 2, 0, true);   // tile_id = 0 (disabled)
     }
@@ -436,38 +518,26 @@ void syscall_clear_sprite_range(Cpu_t* cpu) {
 }
 
 void syscall_check_collision(Cpu_t* cpu) {
-    uint8_t sprite1_id = cpu->r[1] & 0xFF;
-    uint8_t sprite2_id = cpu->r[2] & 0xFF;
+    uint16_t sprite1_id = cpu->r[1];
+    uint16_t sprite2_id = cpu->r[2];
     
     if (sprite1_id >= MAX_SPRITES || sprite2_id >= MAX_SPRITES) {
         cpu->r[1] = 0; // Error: invalid sprite ID
         return;
     }
     
-    // Get positions and tile IDs of both sprites
-    uint16_t sprite1_addr = SPRITE_TABLE_START + (sprite1_id * 3);
-    uint16_t sprite2_addr = SPRITE_TABLE_START + (sprite2_id * 3);
-    
-    uint8_t x1 = memory_read_byte(cpu->memory, sprite1_addr + 0);
-    uint8_t y1 = memory_read_byte(cpu->memory, sprite1_addr + 1);
-    uint8_t tile1 = memory_read_byte(cpu->memory, sprite1_addr + 2);
-    uint8_t x2 = memory_read_byte(cpu->memory, sprite2_addr + 0);
-    uint8_t y2 = memory_read_byte(cpu->memory, sprite2_addr + 1);
-    uint8_t tile2 = memory_read_byte(cpu->memory, sprite2_addr + 2);
-    
-    // No collision if either sprite is disabled (tile_id = 0) or off-screen
-    if (tile1 == 0 || tile2 == 0 || 
-        x1 >= SCREEN_WIDTH_TILES || y1 >= SCREEN_HEIGHT_TILES ||
-        x2 >= SCREEN_WIDTH_TILES || y2 >= SCREEN_HEIGHT_TILES) {
+    // Disabled (tile_id = 0) and off-screen sprites are not in the occupancy grid
+    uint16_t cell = video_sprite_cell(sprite1_id);
+    if (cell == VIDEO_NO_CELL) {
         cpu->r[1] = 0; // No collision
         return;
     }
-    cpu->r[1] = ((x1 == x2) && (y1 == y2)); // Return collision result
+    cpu->r[1] = (cell == video_sprite_cell(sprite2_id)); // Return collision result
 }
 
 void syscall_shift_sprites(Cpu_t* cpu) {
-    uint8_t start_id = cpu->r[1] & 0xFF;
-    uint8_t count = cpu->r[2] & 0xFF;
+    uint16_t start_id = cpu->r[1];
+    uint16_t count = cpu->r[2];
     int8_t dx = (int8_t)(cpu->r[3] & 0xFF);
     int8_t dy = (int8_t)(cpu->r[4] & 0xFF);
     
@@ -477,8 +547,8 @@ void syscall_shift_sprites(Cpu_t* cpu) {
     }
     
     // Move sprites in sequence
-    for (uint8_t i = 0; i < count; i++) {
-        uint8_t sprite_id = start_id + i;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t sprite_id = start_id + i;
         uint16_t sprite_addr = SPRITE_TABLE_START + (sprite_id * 3);
         
         uint8_t current_x = memory_read_byte(cpu->memory, sprite_addr + 0);
@@ -502,8 +572,8 @@ void syscall_shift_sprites(Cpu_t* cpu) {
 }
 
 void syscall_copy_sprite(Cpu_t* cpu) {
-    uint8_t src_id = cpu->r[1] & 0xFF;
-    uint8_t dest_id = cpu->r[2] & 0xFF;
+    uint16_t src_id = cpu->r[1];
+    uint16_t dest_id = cpu->r[2];
     
     if (src_id >= MAX_SPRITES || dest_id >= MAX_SPRITES) {
         cpu->r[1] = 0; // Error: invalid sprite ID
@@ -531,7 +601,7 @@ void syscall_set_return_addr(Cpu_t* cpu) {
 }
 
 void syscall_move_sprite_right(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t tiles = cpu->r[2] & 0xFF;
     
     if (sprite_id >= MAX_SPRITES) {
@@ -553,7 +623,7 @@ void syscall_move_sprite_right(Cpu_t* cpu) {
 }
 
 void syscall_move_sprite_left(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t tiles = cpu->r[2] & 0xFF;
     
     if (sprite_id >= MAX_SPRITES) {
@@ -575,7 +645,7 @@ void syscall_move_sprite_left(Cpu_t* cpu) {
 }
 
 void syscall_move_sprite_up(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t tiles = cpu->r[2] & 0xFF;
     
     if (sprite_id >= MAX_SPRITES) {
@@ -597,7 +667,7 @@ void syscall_move_sprite_up(Cpu_t* cpu) {
 }
 
 void syscall_move_sprite_down(Cpu_t* cpu) {
-    uint8_t sprite_id = cpu->r[1] & 0xFF;
+    uint16_t sprite_id = cpu->r[1];
     uint8_t tiles = cpu->r[2] & 0xFF;
     
     if (sprite_id >= MAX_SPRITES) {
@@ -618,12 +688,16 @@ void syscall_move_sprite_down(Cpu_t* cpu) {
     cpu->r[1] = success;
 }
 
+// Guest time in milliseconds, counted in frames at the configured refresh rate
+static uint32_t guest_time_ms(const Cpu_t* cpu) {
+    return (uint32_t)((uint64_t)cpu->frame_count * 1000 / timing_refresh_hz());
+}
+
 void syscall_timer_start(Cpu_t* cpu) {
     uint16_t duration = cpu->r[1]; // Duration in milliseconds
     
     // Store current time in cpu->last_time (using frame counter as time base)
-    uint32_t current_time_ms = (cpu->frame_count * 1000) / 60; // Convert frames to milliseconds
-    cpu->last_time = current_time_ms;
+    cpu->last_time = guest_time_ms(cpu);
     
     // Store duration in timer registers for reference
     bool success = memory_write_word(cpu->memory, TIMER_COUNTER_LOW, duration, true);
@@ -639,8 +713,7 @@ void syscall_timer_query(Cpu_t* cpu) {
     uint16_t duration = memory_read_word(cpu->memory, TIMER_COUNTER_LOW);
     
     // Calculate current time and elapsed time
-    uint32_t current_time_ms = (cpu->frame_count * 1000) / 60;
-    uint32_t elapsed_ms = current_time_ms - cpu->last_time;
+    uint32_t elapsed_ms = guest_time_ms(cpu) - cpu->last_time;
     
     uint16_t timer_state;
     if (elapsed_ms >= duration || duration == 0) {
@@ -720,3 +793,132 @@ void syscall_number_to_string(Cpu_t* cpu) {
     cpu->r[2] = success; // Success code
 }
 
+
+// Records validated per pass of syscall_update_sprites
+#define SPRITE_BATCH 64
+
+void syscall_update_sprites(Cpu_t* cpu) {
+    uint16_t list_addr = cpu->r[1];
+    uint16_t count = cpu->r[2];
+
+    // The whole descriptor list has to be inside memory
+    if ((uint32_t)list_addr + (uint32_t)count * SPRITE_RECORD_SIZE > MEMORY_SIZE) {
+        cpu->r[1] = 0; // Error: descriptor list out of range
+        return;
+    }
+
+    const uint8_t* records = cpu->memory + list_addr;
+    uint16_t applied = 0;
+    for (uint16_t base = 0; base < count; base += SPRITE_BATCH) {
+        uint16_t batch = (count - base) < SPRITE_BATCH ? (count - base) : SPRITE_BATCH;
+        const uint8_t* batch_records = records + base * SPRITE_RECORD_SIZE;
+
+        // Validate the batch without branches (same rules as syscall_set_sprite).
+        // The id is a word as the guest stored it, so it is read in memory's byte order.
+        uint16_t ids[SPRITE_BATCH];
+        uint8_t valid[SPRITE_BATCH];
+        for (uint16_t i = 0; i < batch; i++) {
+            const uint8_t* record = batch_records + i * SPRITE_RECORD_SIZE;
+            ids[i] = memory_read_word(cpu->memory, list_addr + (base + i) * SPRITE_RECORD_SIZE);
+            valid[i] = (ids[i] < MAX_SPRITES) & (record[2] < SCREEN_WIDTH_TILES) &
+                       (record[3] < SCREEN_HEIGHT_TILES) & (record[4] <= MAX_TILES);
+        }
+
+        // Apply the valid records; invalid ones are skipped
+        for (uint16_t i = 0; i < batch; i++) {
+            if (!valid[i]) continue;
+            const uint8_t* record = batch_records + i * SPRITE_RECORD_SIZE;
+            uint16_t sprite_addr = SPRITE_TABLE_START + (ids[i] * 3);
+            applied += memory_write_block(cpu->memory, sprite_addr, record + 2, 3, true);
+        }
+    }
+
+    cpu->r[1] = applied; // Return number of sprites updated
+}
+
+void syscall_load_tiles(Cpu_t* cpu) {
+    uint16_t src_addr = cpu->r[1];
+    uint16_t first_tile = cpu->r[2];
+    uint16_t tile_count = cpu->r[3];
+    uint32_t length = (uint32_t)tile_count * TILE_SIZE * TILE_SIZE;
+
+    // Tile ids are 1-based like syscall_set_tile_pixel; the whole run has to fit the tileset
+    if (first_tile == 0 || tile_count == 0 || (first_tile - 1) + tile_count > MAX_TILES ||
+        (uint32_t)src_addr + length > MEMORY_SIZE) {
+        cpu->r[1] = 0; // Error: invalid tile range or source
+        return;
+    }
+
+    // One copy, so each tile's cached image is invalidated once
+    uint16_t dest_addr = TILESET_DATA_START + ((first_tile - 1) * TILE_SIZE * TILE_SIZE);
+    bool success = memory_write_block(cpu->memory, dest_addr, cpu->memory + src_addr, length, true);
+
+    cpu->r[1] = success ? tile_count : 0; // Return number of tiles loaded
+}
+
+void syscall_load_palette(Cpu_t* cpu) {
+    uint16_t src_addr = cpu->r[1];
+    uint16_t length = PALETTE_SIZE * 2;
+
+    if ((uint32_t)src_addr + length > MEMORY_SIZE) {
+        cpu->r[1] = 0; // Error: source out of range
+        return;
+    }
+
+    // Palette RAM holds the words in the same layout as the source, so copy the bytes as-is
+    bool success = memory_write_block(cpu->memory, PALETTE_RAM_START, cpu->memory + src_addr, length, true);
+
+    cpu->r[1] = success;
+}
+
+void syscall_collide_sprites(Cpu_t* cpu) {
+    uint16_t a_first = cpu->r[1];
+    uint16_t a_last = cpu->r[2];
+    uint16_t b_first = cpu->r[3];
+    uint16_t b_last = cpu->r[4];
+    uint16_t out_addr = cpu->r[5];
+    uint16_t max_records = cpu->r[6];
+
+    // One record (a_id, b_id) per colliding pair, up to the caller's capacity
+    uint32_t max_length = (uint32_t)max_records * 4;
+    if (a_first > a_last || a_last >= MAX_SPRITES || b_first > b_last || b_last >= MAX_SPRITES ||
+        (uint32_t)out_addr + max_length > MEMORY_SIZE) {
+        cpu->r[1] = 0; // Error: invalid sprite range or output buffer
+        return;
+    }
+
+    uint16_t hits = 0;
+    for (uint16_t a = video_next_active_sprite(a_first); a <= a_last; a = video_next_active_sprite(a + 1)) {
+        uint16_t cell = video_sprite_cell(a);
+        if (cell == VIDEO_NO_CELL) continue;
+
+        // Only the sprites sharing a's cell can collide with it; report them lowest id first
+        uint16_t cell_hits[MAX_SPRITES];
+        int count = 0;
+        for (uint16_t b = video_first_sprite_in_cell(cell); b < MAX_SPRITES; b = video_next_sprite_in_cell(b)) {
+            if (b == a || b < b_first || b > b_last) continue;
+            int at = count++;
+            while (at > 0 && cell_hits[at - 1] > b) {
+                cell_hits[at] = cell_hits[at - 1];
+                at--;
+            }
+            cell_hits[at] = b;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (hits == max_records) {
+                cpu->r[1] = hits;
+                return;
+            }
+            uint16_t record_addr = out_addr + (hits * 4);
+            if (!memory_write_word(cpu->memory, record_addr, a, false) ||
+                !memory_write_word(cpu->memory, record_addr + 2, cell_hits[i], false)) {
+                cpu->r[1] = hits;
+                return;
+            }
+            hits++;
+        }
+    }
+
+    cpu->r[1] = hits; // Return number of records written
+}
@@ -0,0 +1,92 @@
+#include "idn16/timing.h"
+#include "idn16/cpu.h"
+#include <ctype.h>
+#include <stdlib.h>
+
+static uint32_t clock_hz = CPU_CLOCK_HZ;
+static uint32_t refresh_hz = DISPLAY_REFRESH_HZ;
+
+bool timing_set(uint32_t clock, uint32_t refresh) {
+    if (clock < MIN_CLOCK_HZ || clock > MAX_CLOCK_HZ || refresh < MIN_REFRESH_HZ || refresh > MAX_REFRESH_HZ || clock < refresh) {
+        return false;
+    }
+    clock_hz = clock;
+    refresh_hz = refresh;
+    return true;
+}
+
+uint32_t timing_clock_hz(void) {
+    return clock_hz;
+}
+
+uint32_t timing_refresh_hz(void) {
+    return refresh_hz;
+}
+
+uint32_t timing_cycles_per_frame(void) {
+    return clock_hz / refresh_hz;
+}
+
+uint64_t timing_frame_ns(void) {
+    return NS_PER_SECOND / refresh_hz;
+}
+
+bool timing_parse_hz(const char* text, uint32_t* hz) {
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text) return false;
+
+    double scale = 1.0;
+    if (tolower((unsigned char)*end) == 'k') {
+        scale = 1e3;
+        end++;
+    } else if (tolower((unsigned char)*end) == 'm') {
+        scale = 1e6;
+        end++;
+    }
+    if (tolower((unsigned char)end[0]) == 'h' && tolower((unsigned char)end[1]) == 'z') end += 2;
+    if (*end != '\0') return false;
+
+    value *= scale;
+    if (!(value >= 1.0) || value > 4e9) return false;
+    *hz = (uint32_t)(value + 0.5);
+    return true;
+}
+
+void pacer_start(pacer_t* pacer, uint32_t hz, uint32_t max_lag, uint64_t now_ns) {
+    pacer->hz = hz;
+    pacer->start_ns = now_ns;
+    pacer->ticks = 0;
+    pacer->max_lag = max_lag;
+}
+
+// Tick n is due at start_ns + n * NS_PER_SECOND / hz, rounded down
+static uint64_t tick_due_ns(const pacer_t* pacer, uint64_t tick) {
+    return pacer->start_ns + tick * NS_PER_SECOND / pacer->hz;
+}
+
+uint32_t pacer_due(pacer_t* pacer, uint64_t now_ns) {
+    if (now_ns < tick_due_ns(pacer, pacer->ticks)) return 0;
+
+    // Ticks 0 to available - 1 are due by now
+    uint64_t elapsed = now_ns - pacer->start_ns;
+    uint64_t available = ((elapsed + 1) * pacer->hz - 1) / NS_PER_SECOND + 1;
+    uint64_t due = available - pacer->ticks;
+    if (due > pacer->max_lag) {
+        pacer->start_ns = now_ns;
+        pacer->ticks = 1;
+        return 1;
+    }
+    pacer->ticks = available;
+
+    // Move the grid's origin forward a whole second at a time so the products stay small
+    while (pacer->ticks >= pacer->hz) {
+        pacer->start_ns += NS_PER_SECOND;
+        pacer->ticks -= pacer->hz;
+    }
+    return (uint32_t)due;
+}
+
+uint64_t pacer_next_ns(const pacer_t* pacer) {
+    return tick_due_ns(pacer, pacer->ticks);
+}
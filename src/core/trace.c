@@ -0,0 +1,177 @@
+#include "idn16/trace.h"
+#include "idn16/labels.h"
+#include "idn16/dasm.h"
+#include <string.h>
+
+static trace_record_t ring[TRACE_RING_SIZE];
+static uint32_t ring_next = 0;      // Total records written; the newest is at ring_next - 1
+
+static FILE* stream = NULL;
+static trace_record_t stream_prev;
+
+void trace_record(const Cpu_t* cpu, uint16_t pc, uint16_t instruction, const uint16_t before[8]) {
+    trace_record_t* record = &ring[ring_next++ & (TRACE_RING_SIZE - 1)];
+    record->pc = pc;
+    record->instruction = instruction;
+    record->changed = 0;
+    record->flags = cpu->flags.z | (cpu->flags.n << 1) | (cpu->flags.c << 2) | (cpu->flags.v << 3);
+    int values = 0;
+    for (int r = 0; r < 8; r++) {
+        if (cpu->r[r] != before[r]) {
+            record->changed |= 1 << r;
+            record->values[values++] = cpu->r[r];
+        }
+    }
+
+    if (stream) {
+        uint8_t bytes[TRACE_RECORD_MAX_BYTES];
+        int length = trace_encode(record, &stream_prev, bytes);
+        if (fwrite(bytes, 1, length, stream) != (size_t)length) {
+            fprintf(stderr, "Error: Trace stream write failed, tracing to disk stopped\n");
+            trace_stream_close();
+        }
+    }
+}
+
+void trace_clear(void) {
+    ring_next = 0;
+}
+
+int trace_last(trace_record_t* out, int max) {
+    uint32_t available = ring_next < TRACE_RING_SIZE ? ring_next : TRACE_RING_SIZE;
+    int count = max < (int)available ? max : (int)available;
+    for (int i = 0; i < count; i++) {
+        out[i] = ring[(ring_next - count + i) & (TRACE_RING_SIZE - 1)];
+    }
+    return count;
+}
+
+void trace_dump(FILE* out, int count) {
+    static trace_record_t records[TRACE_RING_SIZE];
+    count = trace_last(records, count < TRACE_RING_SIZE ? count : TRACE_RING_SIZE);
+    fprintf(out, "Last %d instructions, oldest first:\n", count);
+    for (int i = 0; i < count; i++) {
+        char line[TRACE_LINE_LENGTH];
+        trace_format(&records[i], line, sizeof(line));
+        fprintf(out, "%s\n", line);
+    }
+}
+
+bool trace_stream_open(const char* path) {
+    trace_stream_close();
+    stream = fopen(path, "wb");
+    if (!stream) {
+        fprintf(stderr, "Error: Unable to create trace file %s\n", path);
+        return false;
+    }
+    memset(&stream_prev, 0, sizeof(stream_prev));
+    if (!trace_write_header(stream)) {
+        fprintf(stderr, "Error: Unable to write trace file %s\n", path);
+        fclose(stream);
+        stream = NULL;
+        return false;
+    }
+    return true;
+}
+
+void trace_stream_close(void) {
+    if (stream) {
+        fclose(stream);
+        stream = NULL;
+    }
+}
+
+static int value_count(uint8_t changed) {
+    int count = 0;
+    for (; changed; changed &= changed - 1) count++;
+    return count;
+}
+
+int trace_encode(const trace_record_t* record, trace_record_t* prev, uint8_t out[TRACE_RECORD_MAX_BYTES]) {
+    int length = 1;
+    uint8_t tag = 0;
+    if (record->pc != (uint16_t)(prev->pc + 2)) {
+        tag |= TRACE_TAG_PC;
+        out[length++] = record->pc & 0xFF;
+        out[length++] = record->pc >> 8;
+    }
+    out[length++] = record->instruction & 0xFF;
+    out[length++] = record->instruction >> 8;
+    out[length++] = record->changed;
+    if (record->flags != prev->flags) {
+        tag |= TRACE_TAG_FLAGS;
+        out[length++] = record->flags;
+    }
+    for (int i = 0; i < value_count(record->changed); i++) {
+        out[length++] = record->values[i] & 0xFF;
+        out[length++] = record->values[i] >> 8;
+    }
+    out[0] = tag;
+    *prev = *record;
+    return length;
+}
+
+bool trace_write_header(FILE* file) {
+    return fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LENGTH, file) == TRACE_MAGIC_LENGTH
+        && fputc(TRACE_VERSION, file) != EOF;
+}
+
+bool trace_read_header(FILE* file) {
+    char magic[TRACE_MAGIC_LENGTH];
+    if (fread(magic, 1, TRACE_MAGIC_LENGTH, file) != TRACE_MAGIC_LENGTH
+        || memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0) {
+        return false;
+    }
+    return fgetc(file) == TRACE_VERSION;
+}
+
+static bool read_le_word(FILE* file, uint16_t* value) {
+    int low = fgetc(file);
+    int high = fgetc(file);
+    if (low == EOF || high == EOF) return false;
+    *value = (uint16_t)(low | (high << 8));
+    return true;
+}
+
+bool trace_read_record(FILE* file, trace_record_t* prev, trace_record_t* record) {
+    int tag = fgetc(file);
+    if (tag == EOF) return false;
+    memset(record, 0, sizeof(*record));
+    record->pc = prev->pc + 2;
+    if ((tag & TRACE_TAG_PC) && !read_le_word(file, &record->pc)) return false;
+    if (!read_le_word(file, &record->instruction)) return false;
+    int changed = fgetc(file);
+    if (changed == EOF) return false;
+    record->changed = (uint8_t)changed;
+    record->flags = prev->flags;
+    if (tag & TRACE_TAG_FLAGS) {
+        int flags = fgetc(file);
+        if (flags == EOF) return false;
+        record->flags = (uint8_t)flags;
+    }
+    for (int i = 0; i < value_count(record->changed); i++) {
+        if (!read_le_word(file, &record->values[i])) return false;
+    }
+    *prev = *record;
+    return true;
+}
+
+void trace_format(const trace_record_t* record, char* out, size_t size) {
+    char location[LABEL_NAME_LENGTH + 8] = "";
+    uint16_t offset;
+    const char* label = labels_lookup(record->pc, &offset);
+    if (label) snprintf(location, sizeof(location), "%s+%u", label, offset);
+
+    const char* text = disassemble_word(record->instruction);
+    char changes[8 * 8 + 1] = "";
+    int length = 0, values = 0;
+    for (int r = 0; r < 8; r++) {
+        if (!(record->changed & (1 << r))) continue;
+        length += snprintf(changes + length, sizeof(changes) - length, "r%d=%04X ", r, record->values[values++]);
+    }
+
+    snprintf(out, size, "0x%04X %-20s %-22.*s %-24s %c%c%c%c", record->pc, location,
+             (int)strcspn(text, "\n"), text, changes,
+             record->flags & TRACE_FLAG_Z ? 'Z' : '-', record->flags & TRACE_FLAG_N ? 'N' : '-',
+             record->flags & TRACE_FLAG_C ? 'C' : '-', record->flags & TRACE_FLAG_V ? 'V' : '-');
+}
@@ -0,0 +1,281 @@
+#include "idn16/video.h"
+
+// Generation counters only ever increase, so a cache built against an older
+// memory image can never mistake itself for current after a reset.
+static uint32_t palette_generation = 0;
+static uint32_t tile_generation[MAX_TILES] = {0};
+
+// Palette lookup tables, indexed by palette entry
+static uint16_t palette_rgb565[PALETTE_SIZE] = {0};
+static uint32_t palette_xrgb8888[PALETTE_SIZE] = {0};
+
+// Text colors as last written to the video control registers
+static uint16_t text_fg_color = 0;
+static uint16_t text_bg_color = 0;
+
+// One bit per sprite table entry, set while the sprite's tile_id is non-zero
+static uint64_t active_sprites[VIDEO_SPRITE_WORDS] = {0};
+static uint16_t active_sprite_count = 0;
+
+// Occupancy grid: one doubly linked list of sprites per 40x30 screen cell.
+// Only active sprites with on-screen coordinates are linked in; MAX_SPRITES ends a list.
+#define GRID_CELLS (SCREEN_WIDTH_TILES * SCREEN_HEIGHT_TILES)
+static uint16_t cell_head[GRID_CELLS];
+static uint16_t cell_next[MAX_SPRITES];
+static uint16_t cell_prev[MAX_SPRITES];
+static uint16_t sprite_cell[MAX_SPRITES];
+
+static void update_palette_entry(uint8_t memory[], uint8_t index) {
+    uint16_t color = memory_read_word(memory, PALETTE_RAM_START + (index * 2));
+    palette_rgb565[index] = color;
+    palette_xrgb8888[index] = video_rgb565_to_xrgb8888(color);
+}
+
+static void unlink_from_cell(uint16_t sprite_id) {
+    uint16_t cell = sprite_cell[sprite_id];
+    if (cell == VIDEO_NO_CELL) return;
+    uint16_t next = cell_next[sprite_id];
+    uint16_t prev = cell_prev[sprite_id];
+    if (prev < MAX_SPRITES) {
+        cell_next[prev] = next;
+    } else {
+        cell_head[cell] = next;
+    }
+    if (next < MAX_SPRITES) {
+        cell_prev[next] = prev;
+    }
+    sprite_cell[sprite_id] = VIDEO_NO_CELL;
+}
+
+static void link_into_cell(uint16_t sprite_id, uint16_t cell) {
+    uint16_t head = cell_head[cell];
+    cell_next[sprite_id] = head;
+    cell_prev[sprite_id] = MAX_SPRITES;
+    if (head < MAX_SPRITES) {
+        cell_prev[head] = sprite_id;
+    }
+    cell_head[cell] = sprite_id;
+    sprite_cell[sprite_id] = cell;
+}
+
+static void update_sprite(uint8_t memory[], uint16_t sprite_id) {
+    const uint8_t* sprite = memory + SPRITE_TABLE_START + (sprite_id * 3);
+    uint64_t bit = (uint64_t)1 << (sprite_id % 64);
+    uint64_t* word = &active_sprites[sprite_id / 64];
+    bool was_active = (*word & bit) != 0;
+    bool is_active = sprite[2] != 0;
+    if (is_active && !was_active) {
+        *word |= bit;
+        active_sprite_count++;
+    } else if (!is_active && was_active) {
+        *word &= ~bit;
+        active_sprite_count--;
+    }
+
+    // Keep the sprite in the grid cell it covers, if it is visible at all
+    uint16_t cell = VIDEO_NO_CELL;
+    if (is_active && sprite[0] < SCREEN_WIDTH_TILES && sprite[1] < SCREEN_HEIGHT_TILES) {
+        cell = sprite[1] * SCREEN_WIDTH_TILES + sprite[0];
+    }
+    if (cell != sprite_cell[sprite_id]) {
+        unlink_from_cell(sprite_id);
+        if (cell != VIDEO_NO_CELL) {
+            link_into_cell(sprite_id, cell);
+        }
+    }
+}
+
+void video_state_reset(uint8_t memory[]) {
+    palette_generation++;
+    for (uint8_t i = 0; i < PALETTE_SIZE; i++) {
+        update_palette_entry(memory, i);
+    }
+    text_fg_color = memory_read_word(memory, TEXT_FG_COLOR_REG);
+    text_bg_color = memory_read_word(memory, TEXT_BG_COLOR_REG);
+    for (int i = 0; i < MAX_TILES; i++) {
+        tile_generation[i]++;
+    }
+
+    memset(active_sprites, 0, sizeof(active_sprites));
+    active_sprite_count = 0;
+    for (int i = 0; i < GRID_CELLS; i++) {
+        cell_head[i] = MAX_SPRITES;
+    }
+    for (int i = 0; i < MAX_SPRITES; i++) {
+        sprite_cell[i] = VIDEO_NO_CELL;
+    }
+    for (uint16_t id = 0; id < MAX_SPRITES; id++) {
+        update_sprite(memory, id);
+    }
+}
+
+void video_state_on_write(uint8_t memory[], uint16_t address) {
+    if (address >= PALETTE_RAM_START && address <= PALETTE_RAM_END) {
+        update_palette_entry(memory, (address - PALETTE_RAM_START) / 2);
+        palette_generation++;
+    } else if (address >= TEXT_FG_COLOR_REG && address <= TEXT_BG_COLOR_REG + 1) {
+        text_fg_color = memory_read_word(memory, TEXT_FG_COLOR_REG);
+        text_bg_color = memory_read_word(memory, TEXT_BG_COLOR_REG);
+    } else if (address >= SPRITE_TABLE_START && address <= SPRITE_TABLE_END) {
+        uint16_t offset = address - SPRITE_TABLE_START;
+        // Any byte can move the sprite to another grid cell
+        if (offset / 3 < MAX_SPRITES) {
+            update_sprite(memory, offset / 3);
+        }
+    } else if (address >= TILESET_DATA_START && address <= TILESET_DATA_END) {
+        uint16_t tile_index = (address - TILESET_DATA_START) / (TILE_SIZE * TILE_SIZE);
+        if (tile_index < MAX_TILES) {
+            tile_generation[tile_index]++;
+        }
+    }
+}
+
+void video_state_on_write_range(uint8_t memory[], uint16_t first, uint16_t last) {
+    if (first <= PALETTE_RAM_END && last >= PALETTE_RAM_START) {
+        uint16_t from = (first > PALETTE_RAM_START ? first : PALETTE_RAM_START) - PALETTE_RAM_START;
+        uint16_t to = (last < PALETTE_RAM_END ? last : PALETTE_RAM_END) - PALETTE_RAM_START;
+        for (uint16_t entry = from / 2; entry <= to / 2; entry++) {
+            update_palette_entry(memory, entry);
+        }
+        palette_generation++;
+    }
+    if (first <= TEXT_BG_COLOR_REG + 1 && last >= TEXT_FG_COLOR_REG) {
+        text_fg_color = memory_read_word(memory, TEXT_FG_COLOR_REG);
+        text_bg_color = memory_read_word(memory, TEXT_BG_COLOR_REG);
+    }
+    if (first <= SPRITE_TABLE_END && last >= SPRITE_TABLE_START) {
+        uint16_t from = (first > SPRITE_TABLE_START ? first : SPRITE_TABLE_START) - SPRITE_TABLE_START;
+        uint16_t to = (last < SPRITE_TABLE_END ? last : SPRITE_TABLE_END) - SPRITE_TABLE_START;
+        for (uint16_t id = from / 3; id <= to / 3 && id < MAX_SPRITES; id++) {
+            update_sprite(memory, id);
+        }
+    }
+    if (first <= TILESET_DATA_END && last >= TILESET_DATA_START) {
+        uint16_t from = (first > TILESET_DATA_START ? first : TILESET_DATA_START) - TILESET_DATA_START;
+        uint16_t to = (last < TILESET_DATA_END ? last : TILESET_DATA_END) - TILESET_DATA_START;
+        for (uint16_t tile = from / (TILE_SIZE * TILE_SIZE); tile <= to / (TILE_SIZE * TILE_SIZE) && tile < MAX_TILES; tile++) {
+            tile_generation[tile]++;
+        }
+    }
+}
+
+uint32_t video_palette_generation(void) {
+    return palette_generation;
+}
+
+uint32_t video_tile_generation(uint8_t tile_index) {
+    if (tile_index >= MAX_TILES) return 0;
+    return tile_generation[tile_index];
+}
+
+const uint16_t* video_palette_rgb565(void) {
+    return palette_rgb565;
+}
+
+const uint32_t* video_palette_xrgb8888(void) {
+    return palette_xrgb8888;
+}
+
+void video_text_colors(uint16_t* fg_color, uint16_t* bg_color) {
+    // Use default colors if not set
+    if (text_fg_color == 0 && text_bg_color == 0) {
+        *fg_color = 0xFFFF; // White
+        *bg_color = 0x0000; // Black
+        return;
+    }
+    *fg_color = text_fg_color;
+    *bg_color = text_bg_color;
+}
+
+uint32_t video_rgb565_to_xrgb8888(uint16_t color) {
+    // Replicate the top bits into the low bits so 0x1F/0x3F expand to 0xFF
+    uint32_t r = (color >> 11) & 0x1F;
+    uint32_t g = (color >> 5) & 0x3F;
+    uint32_t b = color & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+bool video_sprite_active(uint16_t sprite_id) {
+    if (sprite_id >= MAX_SPRITES) return false;
+    return (active_sprites[sprite_id / 64] >> (sprite_id % 64)) & 1;
+}
+
+uint16_t video_sprite_cell(uint16_t sprite_id) {
+    if (sprite_id >= MAX_SPRITES) return VIDEO_NO_CELL;
+    return sprite_cell[sprite_id];
+}
+
+uint16_t video_first_sprite_in_cell(uint16_t cell) {
+    if (cell >= GRID_CELLS) return MAX_SPRITES;
+    return cell_head[cell];
+}
+
+uint16_t video_next_sprite_in_cell(uint16_t sprite_id) {
+    if (sprite_id >= MAX_SPRITES || sprite_cell[sprite_id] == VIDEO_NO_CELL) return MAX_SPRITES;
+    return cell_next[sprite_id];
+}
+
+uint16_t video_active_sprite_count(void) {
+    return active_sprite_count;
+}
+
+static uint16_t next_active_in(const uint64_t bitmap[], uint16_t from) {
+    if (from >= MAX_SPRITES) return MAX_SPRITES;
+    uint16_t index = from / 64;
+    // Mask off the sprites below from in the first word
+    uint64_t word = bitmap[index] & (~(uint64_t)0 << (from % 64));
+    while (true) {
+        if (word) {
+            uint16_t id = index * 64 + __builtin_ctzll(word);
+            return id < MAX_SPRITES ? id : MAX_SPRITES;
+        }
+        if (++index >= VIDEO_SPRITE_WORDS) return MAX_SPRITES;
+        word = bitmap[index];
+    }
+}
+
+uint16_t video_next_active_sprite(uint16_t from) {
+    return next_active_in(active_sprites, from);
+}
+
+void video_state_snapshot(video_snapshot_t* snapshot) {
+    snapshot->palette_generation = palette_generation;
+    memcpy(snapshot->tile_generation, tile_generation, sizeof(tile_generation));
+    memcpy(snapshot->palette_rgb565, palette_rgb565, sizeof(palette_rgb565));
+    memcpy(snapshot->palette_xrgb8888, palette_xrgb8888, sizeof(palette_xrgb8888));
+    video_text_colors(&snapshot->text_fg_color, &snapshot->text_bg_color);
+    memcpy(snapshot->active_sprites, active_sprites, sizeof(active_sprites));
+}
+
+uint16_t video_snapshot_next_active_sprite(const video_snapshot_t* snapshot, uint16_t from) {
+    return next_active_in(snapshot->active_sprites, from);
+}
+
+bool video_background_read(uint8_t memory[], video_background_t* background) {
+    uint16_t control = memory_read_word(memory, BG_CONTROL_REG);
+    uint16_t address = memory_read_word(memory, BG_MAP_ADDR_REG);
+    uint16_t width = memory_read_word(memory, BG_MAP_WIDTH_REG);
+    uint16_t height = memory_read_word(memory, BG_MAP_HEIGHT_REG);
+
+    // A map with a bad size or running off the end of memory is not drawn
+    if (!(control & BG_ENABLE) ||
+        width == 0 || width > BG_MAP_MAX_SIZE ||
+        height == 0 || height > BG_MAP_MAX_SIZE ||
+        (uint32_t)address + (uint32_t)(width * height) > MEMORY_SIZE) {
+        return false;
+    }
+
+    background->map_address = address;
+    background->map_width = width;
+    background->map_height = height;
+    background->scroll_x = memory_read_word(memory, BG_SCROLL_X_REG) % (width * TILE_SIZE);
+    background->scroll_y = memory_read_word(memory, BG_SCROLL_Y_REG) % (height * TILE_SIZE);
+    return true;
+}
+
+uint16_t video_background_wrap(int position, uint16_t scroll, uint16_t map_tiles) {
+    return (uint16_t)((position + scroll) % (map_tiles * TILE_SIZE));
+}
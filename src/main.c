@@ -5,11 +5,23 @@
 #include <SDL3_ttf/SDL_ttf.h>
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include "idn16/io/display.h"
 #include "idn16/io/keyboard.h"
 #include "idn16/io/audio.h"
 #include "idn16/cpu.h"
+#include "idn16/syscall_table.h"
+#include "idn16/plugin.h"
+#include "idn16/profiler.h"
+#include "idn16/labels.h"
+#include "idn16/trace.h"
+#include "idn16/coverage.h"
+#include "idn16/breakpoints.h"
+#include "idn16/memview.h"
+#include "idn16/listing.h"
+#include "idn16/timing.h"
+#include "idn16/perf.h"
 #include "idn16/dasm.h"
 #include "idn16/asmblr.h"
 #include "../lib/sfd/sfd.h"
@@ -49,14 +61,23 @@ void *clay_mem;
 
 bool display_registers = false;
 bool display_assembly = false;
+bool display_memory_viewer = false;
+bool display_perf_hud = false;
 bool cycling = false;
 static int visible_menu = -1;
 
 // Step-over debugging state
 bool stepping_over = false;
+
+// Collapsed call stacks are written here on exit when --profile-stacks is given
+static const char* profile_stacks_path = NULL;
+
+// Coverage bitmaps are written here on exit when --coverage is given
+static const char* coverage_path = NULL;
 uint16_t step_over_target = 0;
 
 bool is_fullscreen = false;
+bool true_color_output = false;
 
 
 // Memory dump modal state
@@ -64,10 +85,56 @@ bool show_memory_dump_modal = false;
 char start_addr_buffer[7] = "0x";
 char bytes_per_line_buffer[4] = "16";
 char num_lines_buffer[4] = "10";
-int focused_textbox = -1; // 0=start_addr, 1=bytes_per_line, 2=num_lines, -1=none
+int focused_textbox = -1; // 0=start_addr, 1=bytes_per_line, 2=num_lines, 3=debug command, -1=none
+
+// Debugger command modal state
+bool show_debug_command_modal = false;
+char debug_command_buffer[96] = "";
+
+// Set when resuming so the breakpoint the CPU stopped on does not stop it again
+static bool resuming_from_break = false;
 
 static FILE* loaded_rom_file = NULL;
-static uint64_t sleep_from = 0;
+static uint64_t sleep_elapsed_ns = 0;        // Guest time spent in the current SLEEP
+
+// The emulator runs a guest frame every 1/refresh seconds on its own cadence, paced by
+// emulation_pacer (see timing.h). The UI is only laid out and presented when an event, a finished
+// guest frame or a panel change made it dirty, and at most once per monitor refresh; with nothing
+// to do the main loop waits for events. The last PRECISE_WAIT_NS before a guest frame is slept
+// with SDL_DelayPrecise, since waiting for events only has millisecond resolution.
+#define MAX_CATCH_UP_FRAMES 4
+#define IDLE_WAIT_MS 100
+#define RENDER_POLL_NS SDL_NS_PER_MS          // Wait while the render thread finishes a frame
+#define PRECISE_WAIT_NS (2 * SDL_NS_PER_MS)
+static bool always_redraw = false;          // --always-redraw: lay out and present every iteration
+static bool ui_dirty = true;
+static bool sync_devices = false;           // An event may have changed guest memory
+static uint64_t present_interval_ns = SDL_NS_PER_SECOND / 60;
+static uint64_t next_present_ns = 0;
+static pacer_t emulation_pacer;
+static bool pacing = false;                 // emulation_pacer is started
+
+// Emulation speed: guest frames run per pacer tick, 0 for as many as fit (uncapped).
+// Faster than 1x only the last guest frame of a tick is rasterised.
+static const int speed_multipliers[] = { 1, 2, 4, 0 };
+#define SPEED_COUNT (int)(sizeof(speed_multipliers) / sizeof(*speed_multipliers))
+static int speed_index = 0;
+
+// Guest frames run per SPEED_SAMPLE_NS of wall time, for the speed readout
+#define SPEED_SAMPLE_NS (SDL_NS_PER_SECOND / 2)
+static uint64_t speed_sample_start_ns = 0;
+static uint32_t speed_sample_frames = 0;
+static int speed_percent = 100;
+
+// Memory viewer: only MEMORY_VIEWER_ROWS rows from memory_viewer_top are laid out
+#define MEMORY_VIEWER_ROWS 32
+static int memory_viewer_top = RAM_START / MEMVIEW_BYTES_PER_ROW;
+
+// Assembly listing: ASSEMBLY_ROWS cached lines from word assembly_top, following the PC
+// until scrolled by hand
+#define ASSEMBLY_ROWS 24
+static int assembly_top = 0;
+static bool assembly_follow_pc = true;
 
 // Persistent buffers for register display
 static char register_text_buffers[8][32];
@@ -105,6 +172,10 @@ Clay_Sizing Layout_Assembly = {
     .width = CLAY_SIZING_FIXED(650),
     .height = CLAY_SIZING_GROW(0)
 };
+Clay_Sizing Layout_Memory_Viewer = {
+    .width = CLAY_SIZING_FIXED(400),
+    .height = CLAY_SIZING_GROW(0)
+};
 
 static inline Clay_Dimensions SDL_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *user_data) {
     TTF_Font **fonts = user_data;
@@ -155,6 +226,8 @@ void Modal_Textbox(Clay_String label, char* buffer, int buffer_size, int textbox
     }
 }
 
+void memory_viewer_goto(uint16_t address);
+
 void Modal_OK_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData) {
     if (pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
         // Parse and validate inputs
@@ -177,6 +250,7 @@ void Modal_OK_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo, intp
         if (bytes_per_line > 0 && num_lines > 0) {
             memory_dump(cpu->memory, start_addr, bytes_per_line, num_lines);
         }
+        memory_viewer_goto(start_addr);
         
         // Close modal
         show_memory_dump_modal = false;
@@ -193,6 +267,25 @@ void Modal_Cancel_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo,
     }
 }
 
+void close_debug_command_modal() {
+    show_debug_command_modal = false;
+    focused_textbox = -1;
+    SDL_StopTextInput(window);
+}
+
+void Debug_Command_OK_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData) {
+    if (pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        if (debug_command_buffer[0] && breakpoints_command(debug_command_buffer)) debug_command_buffer[0] = '\0';
+        close_debug_command_modal();
+    }
+}
+
+void Debug_Command_Cancel_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData) {
+    if (pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        close_debug_command_modal();
+    }
+}
+
 // Menu action handler functions
 void run_reset_cpu();
 void file_close_rom() { 
@@ -200,6 +293,9 @@ void file_close_rom() {
         fclose(loaded_rom_file);
         loaded_rom_file = NULL;
     }
+    // The labels belong to the closed ROM; a ROM opened next without a .sym file has none
+    labels_clear();
+    listing_invalidate_all();
     run_reset_cpu();
     printf("Closing ROM...\n"); 
 }
@@ -216,6 +312,12 @@ void file_open_rom() {
         printf("Got file: '%s'\n", filename);
         loaded_rom_file = fopen(filename, "r");
         load_user_rom(cpu->memory, loaded_rom_file);
+
+        // The assembler writes the ROM's labels to <rom>.sym
+        char symbol_file[1024];
+        snprintf(symbol_file, sizeof(symbol_file), "%s.sym", filename);
+        if (labels_load(symbol_file)) printf("Loaded labels from '%s'\n", symbol_file);
+        listing_invalidate_all();
     } else {
         printf("Open canceled\n");
     }
@@ -224,13 +326,60 @@ void file_exit() { cpu->running = false; }
 
 void view_cpu_registers() { display_registers = !display_registers; }
 void view_assembly_listing() { display_assembly = !display_assembly; }
+void view_memory_viewer() {
+    display_memory_viewer = !display_memory_viewer;
+    // Start from the current contents so only later changes are highlighted
+    if (display_memory_viewer) memview_reset(cpu->memory);
+}
+
+void assembly_scroll(int rows) {
+    assembly_top += rows;
+    if (assembly_top > LISTING_WORDS - ASSEMBLY_ROWS) assembly_top = LISTING_WORDS - ASSEMBLY_ROWS;
+    if (assembly_top < 0) assembly_top = 0;
+}
+
+void memory_viewer_scroll(int rows) {
+    memory_viewer_top += rows;
+    if (memory_viewer_top > MEMVIEW_ROWS - MEMORY_VIEWER_ROWS) memory_viewer_top = MEMVIEW_ROWS - MEMORY_VIEWER_ROWS;
+    if (memory_viewer_top < 0) memory_viewer_top = 0;
+}
+
+// Scrolls the memory viewer so address is on its top row
+void memory_viewer_goto(uint16_t address) {
+    memory_viewer_top = 0;
+    memory_viewer_scroll(address / MEMVIEW_BYTES_PER_ROW);
+}
+
+void view_perf_hud() { display_perf_hud = !display_perf_hud; }
 
-void run_start_resume() { if (loaded_rom_file) cycling = true; }
+void view_toggle_true_color() {
+    if (display_set_true_color(display, !true_color_output)) {
+        true_color_output = !true_color_output;
+    }
+}
+
+void run_start_resume() {
+    if (loaded_rom_file) {
+        cycling = true;
+        assembly_follow_pc = true;
+        resuming_from_break = true;
+    }
+}
 void run_pause() { cycling = false;}
+void run_speed_up() {
+    if (speed_index < SPEED_COUNT - 1) speed_index++;
+}
+void run_speed_down() {
+    if (speed_index > 0) speed_index--;
+}
+void run_speed_normal() { speed_index = 0; }
 void run_step_instruction() { 
     if (loaded_rom_file) {
         cycling = false; 
-        cpu_cycle(cpu);
+        assembly_follow_pc = true;
+        if (profiler_enabled()) cpu_cycle_profiled(cpu);
+        else if (coverage_enabled()) cpu_cycle_covered(cpu);
+        else cpu_cycle(cpu);
     }
 }
 
@@ -249,6 +398,7 @@ void run_step_over() {
             step_over_target = cpu->pc + 2;
             stepping_over = true;
             cycling = true;  // Start automatic execution
+            resuming_from_break = true;
             return;
         }
     }
@@ -274,8 +424,14 @@ void run_reset_cpu() {
         fprintf(stderr, "Couldn't load display\n");
         exit(1);
     }
+    if (true_color_output) display_set_true_color(display, true);
     if (loaded_rom_file) load_user_rom(cpu->memory, loaded_rom_file);
     audio_init(cpu->memory);
+    syscall_stats_reset();
+    profiler_reset();
+    trace_clear();
+    sleep_elapsed_ns = 0;
+    if (display_memory_viewer) memview_reset(cpu->memory);
 }
 
 void tools_assembler() { 
@@ -347,6 +503,35 @@ void tools_memory_dump() {
     SDL_StartTextInput(window); // Enable text input events
 }
 
+void tools_syscall_stats() {
+    syscall_stats_print(stdout);
+}
+
+void tools_profiler() {
+    if (profiler_enabled()) {
+        profiler_enable(false);
+        profiler_print_report(stdout, cpu, PROFILE_REPORT_ROWS);
+    } else {
+        profiler_reset();
+        profiler_enable(true);
+        printf("Profiling started, select Profiler again for the report\n");
+    }
+}
+
+void tools_export_call_stacks() {
+    sfd_Options opt = {
+        .title = "Save call stacks for flame graphs",
+        .filter_name = "Collapsed stacks",
+        .filter = "*.folded|*.txt"
+    };
+    const char *output = sfd_save_dialog(&opt);
+    if (!output) {
+        printf("No output selected\n");
+        return;
+    }
+    if (profiler_write_collapsed(output)) printf("Call stacks saved -> %s\n", output);
+}
+
 void view_toggle_fullscreen() {
     is_fullscreen = !is_fullscreen;
     if (is_fullscreen) {
@@ -356,6 +541,26 @@ void view_toggle_fullscreen() {
     }
 }
 
+void debug_toggle_breakpoint() {
+    bool set = breakpoint_toggle(cpu->pc);
+    printf("Breakpoint %s at 0x%04X\n", set ? "set" : "removed", cpu->pc);
+}
+
+void debug_command() {
+    show_debug_command_modal = true;
+    focused_textbox = 3;
+    SDL_StartTextInput(window);
+}
+
+void debug_list_breakpoints() {
+    breakpoints_print(stdout);
+}
+
+void debug_clear_breakpoints() {
+    breakpoints_clear_all();
+    printf("Breakpoints and watchpoints cleared\n");
+}
+
 void debug_goto_address() {
     // Simple implementation: jump to current PC (can be expanded)
     printf("Current PC: 0x%04X\n", cpu->pc);
@@ -364,11 +569,13 @@ void debug_goto_address() {
 typedef void (*MenuAction)(void);
 
 MenuAction file_actions[] = { file_open_rom, file_close_rom, file_exit };
-MenuAction view_actions[] = { view_cpu_registers, view_assembly_listing };
-MenuAction run_actions[] = { run_start_resume, run_pause, run_step_instruction, run_reset_cpu };
-MenuAction tools_actions[] = { tools_assembler, tools_disassembler, tools_memory_dump };
+MenuAction view_actions[] = { view_cpu_registers, view_assembly_listing, view_memory_viewer, view_perf_hud, view_toggle_true_color };
+MenuAction run_actions[] = { run_start_resume, run_pause, run_step_instruction, run_reset_cpu, run_speed_up, run_speed_down, run_speed_normal };
+MenuAction tools_actions[] = { tools_assembler, tools_disassembler, tools_memory_dump, tools_syscall_stats, tools_profiler, tools_export_call_stacks };
+
+MenuAction debug_actions[] = { debug_toggle_breakpoint, debug_command, debug_list_breakpoints, debug_clear_breakpoints };
 
-MenuAction* menu_action_arrays[] = { file_actions, view_actions, run_actions, tools_actions };
+MenuAction* menu_action_arrays[] = { file_actions, view_actions, run_actions, tools_actions, debug_actions };
 
 void Header_Menu_Item_Click(Clay_ElementId elementId, Clay_PointerData pointerInfo, intptr_t userData) {
     if (pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
@@ -452,6 +659,9 @@ Clay_String *file_menu_items[] = {
 Clay_String *view_menu_items[] = {
     &CLAY_STRING("CPU Registers"),
     &CLAY_STRING("Assembly Listing"),
+    &CLAY_STRING("Memory Viewer"),
+    &CLAY_STRING("Performance HUD"),
+    &CLAY_STRING("True Color Output"),
     NULL
 };
 // Run menu items
@@ -460,6 +670,9 @@ Clay_String *run_menu_items[] = {
     &CLAY_STRING("Pause"),
     &CLAY_STRING("Step Instruction"),
     &CLAY_STRING("Reset CPU"),
+    &CLAY_STRING("Faster"),
+    &CLAY_STRING("Slower"),
+    &CLAY_STRING("Normal Speed"),
     NULL
 };
 // Tools menu items
@@ -467,8 +680,81 @@ Clay_String *tools_menu_items[] = {
     &CLAY_STRING("Assembler"),
     &CLAY_STRING("Disassembler"),
     &CLAY_STRING("Memory Dump"),
+    &CLAY_STRING("Syscall Stats"),
+    &CLAY_STRING("Profiler"),
+    &CLAY_STRING("Export Call Stacks"),
     NULL
 };
+// Debug menu items
+Clay_String *debug_menu_items[] = {
+    &CLAY_STRING("Toggle Breakpoint at PC"),
+    &CLAY_STRING("Breakpoint Command"),
+    &CLAY_STRING("List Breakpoints"),
+    &CLAY_STRING("Clear Breakpoints"),
+    NULL
+};
+
+// The performance HUD averages the last PERF_HUD_FRAMES frames and graphs the time of the last
+// PERF_GRAPH_FRAMES, on a scale of two frame budgets
+#define PERF_HUD_FRAMES 60
+#define PERF_GRAPH_FRAMES 120
+#define PERF_GRAPH_HEIGHT 40
+#define AUDIO_BYTES_PER_MS (48000 * 2 * sizeof(float) / 1000)
+
+static void perf_hud(void) {
+    perf_frame_t sum;
+    int count = perf_sum(PERF_HUD_FRAMES, &sum);
+    double seconds = sum.host_ns / 1e9;
+    double per_frame_ms = count ? 1e-6 / count : 0.0;
+
+    static char lines[5][96];
+    int lengths[5];
+    lengths[0] = snprintf(lines[0], sizeof(lines[0]), "Guest %.2f MIPS  %.0f fps",
+                          seconds > 0 ? sum.instructions / seconds / 1e6 : 0.0, seconds > 0 ? sum.guest_frames / seconds : 0.0);
+    lengths[1] = snprintf(lines[1], sizeof(lines[1]), "Frame %.2f ms  cpu %.2f  raster %.2f",
+                          sum.host_ns * per_frame_ms, sum.phase_ns[PERF_CPU] * per_frame_ms, sum.phase_ns[PERF_RASTER] * per_frame_ms);
+    lengths[2] = snprintf(lines[2], sizeof(lines[2]), "upload %.2f  ui %.2f  present %.2f ms",
+                          sum.phase_ns[PERF_UPLOAD] * per_frame_ms, sum.phase_ns[PERF_UI] * per_frame_ms, sum.phase_ns[PERF_PRESENT] * per_frame_ms);
+    lengths[3] = snprintf(lines[3], sizeof(lines[3]), "%.1f syscalls/frame  %.1f dirty cells",
+                          sum.guest_frames ? (double)sum.syscalls / sum.guest_frames : 0.0, count ? (double)sum.dirty_cells / count : 0.0);
+    lengths[4] = snprintf(lines[4], sizeof(lines[4]), "Audio %.1f ms queued",
+                          count ? (double)sum.audio_queued_bytes / count / AUDIO_BYTES_PER_MS : 0.0);
+
+    static perf_frame_t history[PERF_GRAPH_FRAMES];
+    int frames = perf_last(history, PERF_GRAPH_FRAMES);
+    uint64_t budget_ns = timing_frame_ns();
+
+    CLAY((Clay_ElementDeclaration) {
+        .id = CLAY_ID("PerfHud"),
+        .floating = (Clay_FloatingElementConfig) {
+            .attachTo = CLAY_ATTACH_TO_PARENT,
+            .attachPoints = {.element = CLAY_ATTACH_POINT_LEFT_TOP, .parent = CLAY_ATTACH_POINT_LEFT_TOP},
+            .offset = {8, 8},
+        },
+        .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .padding = CLAY_PADDING_ALL(6), .childGap = 3 },
+        .backgroundColor = (Clay_Color){0, 0, 0, 180},
+        .cornerRadius = CLAY_CORNER_RADIUS(4)
+    }) {
+        for (int i = 0; i < 5; i++) {
+            Clay_String line = {.isStaticallyAllocated = false, .length = lengths[i], .chars = lines[i]};
+            CLAY_TEXT(line, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
+        }
+
+        // Frame time graph, newest on the right; frames over budget are red
+        CLAY((Clay_ElementDeclaration) {
+            .layout = { .sizing = { .height = CLAY_SIZING_FIXED(PERF_GRAPH_HEIGHT) }, .childAlignment = { .y = CLAY_ALIGN_Y_BOTTOM } }
+        }) {
+            for (int i = 0; i < frames; i++) {
+                uint64_t frame_ns = history[i].host_ns;
+                float height = frame_ns >= 2 * budget_ns ? PERF_GRAPH_HEIGHT : (float)frame_ns * PERF_GRAPH_HEIGHT / (2 * budget_ns);
+                CLAY((Clay_ElementDeclaration) {
+                    .layout = { .sizing = { .width = CLAY_SIZING_FIXED(2), .height = CLAY_SIZING_FIXED(height) } },
+                    .backgroundColor = frame_ns > budget_ns + budget_ns / 2 ? COLOR_RED : COLOR_GREEN
+                });
+            }
+        }
+    }
+}
 
 Clay_RenderCommandArray App_Create_Layout() {
     Clay_BeginLayout();
@@ -482,6 +768,7 @@ Clay_RenderCommandArray App_Create_Layout() {
         .aspectRatio = { .aspectRatio = 320/240}
     };
     Clay_ElementDeclaration register_section = { .id = CLAY_ID("Registers"), .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = Layout_Registers, .padding = { 8, 8, 8, 8 }, .childGap = 8 }, .backgroundColor = COLOR_DARK };
+    Clay_ElementDeclaration memory_viewer_section = { .id = CLAY_ID("MemoryViewer"), .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = Layout_Memory_Viewer, .padding = { 8, 8, 8, 0 }, .childGap = 2 }, .backgroundColor = COLOR_DARK };
     Clay_ElementDeclaration assembly_section = { .id = CLAY_ID("Assembly"), .layout = { .layoutDirection = CLAY_TOP_TO_BOTTOM, .sizing = Layout_Assembly, .padding = { 8, 8, 8, 0 }, .childGap = 8 }, .backgroundColor = COLOR_DARK };
     Clay_ElementDeclaration memdump_section = { .id = CLAY_ID("Memdump"),
         .floating = (Clay_FloatingElementConfig) {
@@ -494,6 +781,8 @@ Clay_RenderCommandArray App_Create_Layout() {
         },
         .backgroundColor = (Clay_Color){0, 0, 0, 180}
     };
+    Clay_ElementDeclaration debug_command_section = memdump_section;
+    debug_command_section.id = CLAY_ID("DebugCommand");
     
     CLAY(main_section) {
         CLAY(header_section) {
@@ -501,9 +790,25 @@ Clay_RenderCommandArray App_Create_Layout() {
             Header_Button(CLAY_STRING("View_but"), CLAY_STRING("View"), CLAY_STRING("View_menu"), view_menu_items, 1);
             Header_Button(CLAY_STRING("Run_but"), CLAY_STRING("Run"), CLAY_STRING("Run_menu"), run_menu_items, 2);
             Header_Button(CLAY_STRING("Tools_but"), CLAY_STRING("Tools"), CLAY_STRING("Tools_menu"), tools_menu_items, 3);
+            Header_Button(CLAY_STRING("Debug_but"), CLAY_STRING("Debug"), CLAY_STRING("Debug_menu"), debug_menu_items, 4);
+
+            // Speed readout on the right: the selected speed and the speed actually reached
+            CLAY((Clay_ElementDeclaration) { .layout = { .sizing = { .width = CLAY_SIZING_GROW(0) } } });
+            static char speed_buffer[32];
+            int multiplier = speed_multipliers[speed_index];
+            int speed_len;
+            if (!cycling) {
+                speed_len = multiplier ? sprintf(speed_buffer, "%dx  paused", multiplier) : sprintf(speed_buffer, "Uncapped  paused");
+            } else {
+                speed_len = multiplier ? sprintf(speed_buffer, "%dx  %d%%", multiplier, speed_percent) : sprintf(speed_buffer, "Uncapped  %d%%", speed_percent);
+            }
+            Clay_String speed_string = {.isStaticallyAllocated = false, .length = speed_len, .chars = speed_buffer};
+            CLAY_TEXT(speed_string, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
         };
         CLAY(center) {
-            CLAY(emulator_section_decl);
+            CLAY(emulator_section_decl) {
+                if (display_perf_hud) perf_hud();
+            }
             if (display_registers) {
                 CLAY(register_section) {
                     CLAY_TEXT(CLAY_STRING("Registers"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 16, .textColor = COLOR_LIGHT }));
@@ -537,38 +842,78 @@ Clay_RenderCommandArray App_Create_Layout() {
                 CLAY(assembly_section) {
                     CLAY_TEXT(CLAY_STRING("Assembly"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 16, .textColor = COLOR_LIGHT }));
                     
-                    // Show current instruction and some context, avoiding negative addresses
-                    static char inst_buffers[5][80];
-                    static Clay_String inst_strings[5];
-                    int buffer_index = 0;
-                    
-                    // Calculate how many previous instructions we can safely show
-                    int prev_count = (cpu->pc >= 4) ? 2 : (cpu->pc / 2);
-                    int start_offset = -prev_count;
-                    
-                    for (int i = start_offset; i <= 2; i++) {
-                        uint16_t addr = cpu->pc + (i * 2);
-                        
-                        // Skip if address would be negative
-                        if ((int)cpu->pc + (i * 2) < 0) continue;
-                        
-                        uint16_t instruction = memory_read_word(cpu->memory, addr);
-                        bool is_current = (i == 0);
-                        
-                        int len = sprintf(inst_buffers[buffer_index], "%s%04X: %s", 
-                                        is_current ? "> " : " ", 
-                                        addr, 
-                                        disassemble_word(instruction));
-                        inst_strings[buffer_index] = (Clay_String){
-                            .isStaticallyAllocated = false, 
-                            .length = len, 
-                            .chars = inst_buffers[buffer_index]
-                        };
-                        
+                    // Keep the PC in view, a third of the way down
+                    int pc_row = cpu->pc / 2;
+                    if (assembly_follow_pc && (pc_row < assembly_top || pc_row >= assembly_top + ASSEMBLY_ROWS - 2)) {
+                        assembly_top = 0;
+                        assembly_scroll(pc_row - ASSEMBLY_ROWS / 3);
+                    }
+
+                    // Current instruction and breakpoint markers
+                    static Clay_String markers[4] = {
+                        { .isStaticallyAllocated = true, .length = 2, .chars = "  " },
+                        { .isStaticallyAllocated = true, .length = 2, .chars = " *" },
+                        { .isStaticallyAllocated = true, .length = 2, .chars = "> " },
+                        { .isStaticallyAllocated = true, .length = 2, .chars = ">*" },
+                    };
+
+                    for (int row = 0; row < ASSEMBLY_ROWS; row++) {
+                        uint16_t addr = (assembly_top + row) * 2;
+                        bool is_current = addr == cpu->pc;
+                        const char* line = listing_line(cpu->memory, addr);
+                        Clay_String line_string = {.isStaticallyAllocated = false, .length = strlen(line), .chars = line};
                         Clay_Color text_color = is_current ? COLOR_ORANGE : COLOR_LIGHT;
-                        CLAY_TEXT(inst_strings[buffer_index], CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = text_color }));
-                        
-                        buffer_index++;
+
+                        CLAY((Clay_ElementDeclaration) { .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT } }) {
+                            CLAY((Clay_ElementDeclaration) { .layout = { .sizing = { .width = CLAY_SIZING_FIXED(20) } } }) {
+                                CLAY_TEXT(markers[is_current * 2 + breakpoint_at(addr)], CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = text_color }));
+                            }
+                            CLAY_TEXT(line_string, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = text_color }));
+                        }
+                    }
+                };
+            }
+            if (display_memory_viewer) {
+                CLAY(memory_viewer_section) {
+                    CLAY_TEXT(CLAY_STRING("Memory"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 16, .textColor = COLOR_LIGHT }));
+
+                    static char hex_strings[256][3];
+                    static char address_buffers[MEMORY_VIEWER_ROWS][8];
+                    if (!hex_strings[0][0]) {
+                        for (int i = 0; i < 256; i++) sprintf(hex_strings[i], "%02X", i);
+                    }
+
+                    MemoryRegion_t previous_region = REGION_COUNT + 1;
+                    for (int row = 0; row < MEMORY_VIEWER_ROWS; row++) {
+                        uint16_t address = (memory_viewer_top + row) * MEMVIEW_BYTES_PER_ROW;
+
+                        // Region name above the first row of each region
+                        MemoryRegion_t region = memory_get_region(address);
+                        if (region != previous_region) {
+                            const char* name = memory_region_name(region);
+                            Clay_String region_string = {.isStaticallyAllocated = true, .length = strlen(name), .chars = name};
+                            CLAY_TEXT(region_string, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_ORANGE }));
+                            previous_region = region;
+                        }
+
+                        CLAY((Clay_ElementDeclaration) { .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT } }) {
+                            int len = sprintf(address_buffers[row], "%04X", address);
+                            Clay_String address_string = {.isStaticallyAllocated = false, .length = len, .chars = address_buffers[row]};
+                            CLAY((Clay_ElementDeclaration) { .layout = { .sizing = { .width = CLAY_SIZING_FIXED(48) } } }) {
+                                CLAY_TEXT(address_string, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_BLUE }));
+                            }
+                            // Bytes changed in the last frames get a highlighted cell
+                            for (int i = 0; i < MEMVIEW_BYTES_PER_ROW; i++) {
+                                uint16_t byte_address = address + i;
+                                Clay_String byte_string = {.isStaticallyAllocated = true, .length = 2, .chars = hex_strings[cpu->memory[byte_address]]};
+                                CLAY((Clay_ElementDeclaration) {
+                                    .layout = { .sizing = { .width = CLAY_SIZING_FIXED(20) }, .padding = { 2, 2, 0, 0 } },
+                                    .backgroundColor = memview_changed(byte_address) ? COLOR_RED : COLOR_TRANSPARENT
+                                }) {
+                                    CLAY_TEXT(byte_string, CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
+                                }
+                            }
+                        }
                     }
                 };
             }
@@ -637,11 +982,69 @@ Clay_RenderCommandArray App_Create_Layout() {
                 }
             }
         }
+
+        // Debugger command modal
+        if (show_debug_command_modal) {
+            CLAY(debug_command_section) {
+                CLAY((Clay_ElementDeclaration) {
+                    .layout = { 
+                        .layoutDirection = CLAY_TOP_TO_BOTTOM,
+                        .padding = {20, 20, 20, 20},
+                        .childGap = 16,
+                        .sizing = {.width = CLAY_SIZING_FIXED(400), .height = CLAY_SIZING_FIXED(240)}
+                    },
+                    .backgroundColor = COLOR_DARK,
+                    .cornerRadius = CLAY_CORNER_RADIUS(10),
+                    .border = { .color = COLOR_GREEN, .width = {2, 2, 2, 2} }
+                }) {
+                    CLAY_TEXT(CLAY_STRING("Breakpoint Command"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 16, .textColor = COLOR_LIGHT }));
+                    CLAY_TEXT(CLAY_STRING("break <where> [if <condition>]\nwatch <where> [length] [r|w|rw]\ndelete <where>   clear   list"),
+                              CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
+                    Modal_Textbox(CLAY_STRING("Command:"), debug_command_buffer, sizeof(debug_command_buffer), 3);
+
+                    CLAY((Clay_ElementDeclaration) {
+                        .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT, .childGap = 12, .padding = {0, 0, 10, 0} }
+                    }) {
+                        CLAY((Clay_ElementDeclaration) {
+                            .layout = { 
+                                .padding = {12, 12, 8, 8}, 
+                                .sizing = {.width = CLAY_SIZING_FIXED(80), .height = CLAY_SIZING_FIXED(32)},
+                                .childAlignment = {.x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER}
+                            },
+                            .backgroundColor = Clay_Hovered() ? COLOR_GREEN_HOVER : COLOR_GREEN,
+                            .cornerRadius = CLAY_CORNER_RADIUS(5),
+                        }) {
+                            Clay_OnHover(Debug_Command_OK_Click, 0);
+                            CLAY_TEXT(CLAY_STRING("Run"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
+                        }
+                        CLAY((Clay_ElementDeclaration) {
+                            .layout = { 
+                                .padding = {12, 12, 8, 8}, 
+                                .sizing = {.width = CLAY_SIZING_FIXED(80), .height = CLAY_SIZING_FIXED(32)},
+                                .childAlignment = {.x = CLAY_ALIGN_X_CENTER, .y = CLAY_ALIGN_Y_CENTER}
+                            },
+                            .backgroundColor = Clay_Hovered() ? COLOR_RED_HOVER : COLOR_RED,
+                            .cornerRadius = CLAY_CORNER_RADIUS(5),
+                        }) {
+                            Clay_OnHover(Debug_Command_Cancel_Click, 0);
+                            CLAY_TEXT(CLAY_STRING("Cancel"), CLAY_TEXT_CONFIG({ .fontId = FONT_ID, .fontSize = 10, .textColor = COLOR_LIGHT }));
+                        }
+                    }
+                }
+            }
+        }
     };
     return Clay_EndLayout();
 }
 
 /* This function runs once at startup. */
+// Presents are capped at the refresh rate of the monitor the window is on
+static void update_present_interval(void) {
+    const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+    float refresh_rate = (mode && mode->refresh_rate > 0.0f) ? mode->refresh_rate : 60.0f;
+    present_interval_ns = (uint64_t)(SDL_NS_PER_SECOND / refresh_rate);
+}
+
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[]) {
     if (is_wsl()) {
         SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
@@ -660,6 +1063,7 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[]) {
         return SDL_APP_FAILURE;
     }
     SDL_SetWindowResizable(window, true);
+    update_present_interval();
     if (!TTF_Init()) {
         SDL_Log("Couldn't initialize font system: %s\n", SDL_GetError());
         return SDL_APP_FAILURE;
@@ -713,6 +1117,49 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[]) {
     /* Initialize Audio */
     audio_init(cpu->memory);
 
+    /* Load native syscall plugins, enable profiling, tracing and coverage, set the clock and refresh rates */
+    uint32_t clock_hz = CPU_CLOCK_HZ;
+    uint32_t refresh_hz = DISPLAY_REFRESH_HZ;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--plugin") == 0 && i + 1 < argc) {
+            if (!plugin_load(argv[++i])) return SDL_APP_FAILURE;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profiler_enable(true);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            if (!trace_stream_open(argv[++i])) return SDL_APP_FAILURE;
+        } else if (strcmp(argv[i], "--profile-stacks") == 0 && i + 1 < argc) {
+            profile_stacks_path = argv[++i];
+            profiler_enable(true);
+        } else if (strcmp(argv[i], "--coverage") == 0 && i + 1 < argc) {
+            coverage_path = argv[++i];
+            coverage_enable(true);
+        } else if (strcmp(argv[i], "--perf-log") == 0 && i + 1 < argc) {
+            if (!perf_log_open(argv[++i])) return SDL_APP_FAILURE;
+        } else if (strcmp(argv[i], "--always-redraw") == 0) {
+            always_redraw = true;
+        } else if (strcmp(argv[i], "--clock") == 0 && i + 1 < argc) {
+            if (!timing_parse_hz(argv[++i], &clock_hz)) {
+                fprintf(stderr, "Error: Invalid clock rate %s\n", argv[i]);
+                return SDL_APP_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--refresh") == 0 && i + 1 < argc) {
+            if (!timing_parse_hz(argv[++i], &refresh_hz)) {
+                fprintf(stderr, "Error: Invalid refresh rate %s\n", argv[i]);
+                return SDL_APP_FAILURE;
+            }
+        } else {
+            fprintf(stderr, "Ignoring unknown argument: %s\n", argv[i]);
+        }
+    }
+    if (!timing_set(clock_hz, refresh_hz)) {
+        fprintf(stderr, "Error: The clock must be %d to %d Hz and the refresh rate %d to %d Hz, and no faster than the clock\n",
+                MIN_CLOCK_HZ, MAX_CLOCK_HZ, MIN_REFRESH_HZ, MAX_REFRESH_HZ);
+        return SDL_APP_FAILURE;
+    }
+    if (clock_hz != CPU_CLOCK_HZ || refresh_hz != DISPLAY_REFRESH_HZ) {
+        printf("Clock %u Hz, refresh %u Hz, %u cycles per frame\n", clock_hz, refresh_hz, timing_cycles_per_frame());
+    }
+
     return SDL_APP_CONTINUE;
 }
 
@@ -720,6 +1167,9 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[]) {
 SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
     SDL_Keymod mod = SDL_GetModState();
     bool ctrl_pressed = (mod & SDL_KMOD_CTRL) != 0;
+    // Any event may change what the UI shows or, through a menu or shortcut, the machine
+    ui_dirty = true;
+    sync_devices = true;
     switch (event->type) {
         case SDL_EVENT_QUIT:
             cpu->running = false;
@@ -727,7 +1177,18 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
         case SDL_EVENT_KEY_DOWN: {
 
             
-            if (show_memory_dump_modal) {
+            if (show_debug_command_modal) {
+                if (event->key.key == SDLK_ESCAPE) {
+                    close_debug_command_modal();
+                } else if (event->key.key == SDLK_RETURN) {
+                    // Keep the text after an error so it can be corrected
+                    if (debug_command_buffer[0] && breakpoints_command(debug_command_buffer)) debug_command_buffer[0] = '\0';
+                    close_debug_command_modal();
+                } else if (event->key.key == SDLK_BACKSPACE) {
+                    int len = strlen(debug_command_buffer);
+                    if (len > 0) debug_command_buffer[len - 1] = '\0';
+                }
+            } else if (show_memory_dump_modal) {
                 // Handle modal keyboard input
                 if (event->key.key == SDLK_ESCAPE) {
                     show_memory_dump_modal = false;
@@ -756,6 +1217,7 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
                         if (bytes_per_line > 0 && num_lines > 0) {
                             memory_dump(cpu->memory, start_addr, bytes_per_line, num_lines);
                         }
+                        memory_viewer_goto(start_addr);
                         
                         // Close modal
                         show_memory_dump_modal = false;
@@ -830,12 +1292,43 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
                     case SDLK_G:
                         if (ctrl_pressed) debug_goto_address();
                         break;
+                    case SDLK_T:
+                        if (ctrl_pressed) view_toggle_true_color();
+                        break;
+                    case SDLK_B:
+                        if (ctrl_pressed) debug_toggle_breakpoint();
+                        break;
+                    case SDLK_M:
+                        if (ctrl_pressed) view_memory_viewer();
+                        break;
+                    case SDLK_P:
+                        if (ctrl_pressed) view_perf_hud();
+                        break;
+                    case SDLK_EQUALS:
+                        if (ctrl_pressed) run_speed_up();
+                        break;
+                    case SDLK_MINUS:
+                        if (ctrl_pressed) run_speed_down();
+                        break;
+                    case SDLK_0:
+                        if (ctrl_pressed) run_speed_normal();
+                        break;
+                    case SDLK_PAGEUP:
+                        if (display_memory_viewer) memory_viewer_scroll(-MEMORY_VIEWER_ROWS);
+                        break;
+                    case SDLK_PAGEDOWN:
+                        if (display_memory_viewer) memory_viewer_scroll(MEMORY_VIEWER_ROWS);
+                        break;
                 }
             }
             break;
         }
         case SDL_EVENT_TEXT_INPUT:
-            if (show_memory_dump_modal && focused_textbox >= 0) {
+            if (show_debug_command_modal) {
+                int len = strlen(debug_command_buffer);
+                int add = strlen(event->text.text);
+                if (len + add < (int)sizeof(debug_command_buffer)) memcpy(debug_command_buffer + len, event->text.text, add + 1);
+            } else if (show_memory_dump_modal && focused_textbox >= 0) {
                 
                 char* buffer = (focused_textbox == 0) ? start_addr_buffer : 
                                (focused_textbox == 1) ? bytes_per_line_buffer : num_lines_buffer;
@@ -871,7 +1364,7 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
             }
             break;
         case SDL_EVENT_KEY_UP:
-            if (!show_memory_dump_modal) {
+            if (!show_memory_dump_modal && !show_debug_command_modal) {
                 key_handler(display, event);
                 if (event->key.key == SDLK_ESCAPE) {
                     cpu->running = false;
@@ -883,6 +1376,9 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
         case SDL_EVENT_WINDOW_RESIZED:
             Clay_SetLayoutDimensions((Clay_Dimensions) { (float) event->window.data1, (float) event->window.data2 });
             break;
+        case SDL_EVENT_WINDOW_DISPLAY_CHANGED:
+            update_present_interval();
+            break;
         case SDL_EVENT_MOUSE_MOTION:
             Clay_SetPointerState((Clay_Vector2) { event->motion.x, event->motion.y },
                                  event->motion.state & SDL_BUTTON_LMASK);
@@ -892,6 +1388,14 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
                                  event->button.button == SDL_BUTTON_LEFT);
             break;
         case SDL_EVENT_MOUSE_WHEEL:
+            // The memory viewer and assembly listing scroll by rows themselves rather than laying everything out
+            if (display_memory_viewer && Clay_PointerOver(Clay_GetElementId(CLAY_STRING("MemoryViewer")))) {
+                memory_viewer_scroll((int)(-event->wheel.y * 2));
+            }
+            if (display_assembly && Clay_PointerOver(Clay_GetElementId(CLAY_STRING("Assembly")))) {
+                assembly_follow_pc = false;
+                assembly_scroll((int)(-event->wheel.y * 2));
+            }
             Clay_UpdateScrollContainers(true, (Clay_Vector2) { event->wheel.x, event->wheel.y }, 0.01f);
             break;
         case SDL_EVENT_MOUSE_BUTTON_UP:
@@ -902,26 +1406,37 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
 }
 
 /* This function runs once per frame, and is the heart of the program. */
-SDL_AppResult SDL_AppIterate(void *appstate) {
-    if (!cpu->running) {
-        return SDL_APP_SUCCESS;
+// Runs one guest frame of timing_cycles_per_frame() cycles
+static void run_emulation_frame(void) {
+    // SLEEP counts guest frames, so it lasts as long in guest time at any speed
+    if (cpu->sleep_timer > 0) {
+        sleep_elapsed_ns += timing_frame_ns();
+        if (sleep_elapsed_ns >= (uint64_t)cpu->sleep_timer * SDL_NS_PER_MS) {
+            cpu->sleep_timer = 0;
+            sleep_elapsed_ns = 0;
+        }
     }
 
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-    Clay_RenderCommandArray render_commands = App_Create_Layout();
-
-    SDL_Clay_RenderClayCommands(renderer_data, &render_commands);
-    
-    display_update(display, NULL);
-
-    SDL_RenderPresent(renderer);
-
     // Update audio system
     audio_update(cpu->memory);
 
-    for (int i = 0; (i < CYCLES_PER_FRAME) && cycling && cpu->running && cpu->sleep_timer == 0; i++) {
-        cpu_cycle(cpu);
+    // Run one frame's worth of cycles; syscalls that charge extra cycles use up the budget sooner.
+    // The profiled or covered step is picked once per frame so cpu_cycle stays free of their checks.
+    void (*step)(Cpu_t*) = profiler_enabled() ? cpu_cycle_profiled
+                         : coverage_enabled() ? cpu_cycle_covered
+                         : cpu_cycle;
+    // Breakpoints are only checked while any are set.
+    bool check_breakpoints = breakpoints_active();
+    uint64_t frame_end = cpu->cycles + timing_cycles_per_frame();
+    while (cpu->cycles < frame_end && cycling && cpu->running && cpu->sleep_timer == 0) {
+        if (check_breakpoints && !resuming_from_break && breakpoints_check(cpu)) {
+            cycling = false;
+            stepping_over = false;
+            breakpoints_print_hit(stdout);
+            break;
+        }
+        resuming_from_break = false;
+        step(cpu);
         key_handler(display, NULL);
         // Check for step-over completion
         if (stepping_over && cpu->pc == step_over_target) {
@@ -930,27 +1445,173 @@ SDL_AppResult SDL_AppIterate(void *appstate) {
             printf("Step-over completed at 0x%04X\n", cpu->pc);
         }
     }
-    if (cpu->sleep_timer > 0 && sleep_from == 0) {
-        sleep_from = SDL_GetTicks();
-    }
-    if (cpu->sleep_timer > 0 && sleep_from > 0) {
-        uint64_t elapsed = SDL_GetTicks() - sleep_from;
-        if (elapsed >= cpu->sleep_timer) {
-            cpu->sleep_timer = 0;
-            sleep_from = 0;
-        }
-    }
 
     // Increment frame counter every frame
     if (cycling && cpu->running) {
         cpu->frame_count++;
     }
+}
+
+// Runs count guest frames, or with count 0 as many as fit before deadline_ns. Only the last one
+// is handed to the render thread; the ones before it are skipped.
+static void run_guest_frames(uint32_t count, uint64_t deadline_ns) {
+    uint64_t start = SDL_GetTicksNS();
+    uint64_t instructions = cpu->instructions;
+    uint64_t syscalls = syscall_total_calls();
+    uint32_t frames = 0;
+    while (cycling && cpu->running && (count ? frames < count : (frames == 0 || SDL_GetTicksNS() < deadline_ns))) {
+        run_emulation_frame();
+        frames++;
+    }
+    speed_sample_frames += frames;
+
+    perf_frame_t* perf = perf_current();
+    perf->guest_frames += frames;
+    perf->instructions += cpu->instructions - instructions;
+    perf->syscalls += (uint32_t)(syscall_total_calls() - syscalls);
+    perf_add_time(PERF_CPU, SDL_GetTicksNS() - start);
+
+    // Frame boundary: hand video memory to the render thread while the next frames run.
+    // The display counts the snapshot towards PERF_RASTER itself, see end_perf_frame.
+    display_submit_frame(display);
+}
+
+// Collects the display and audio counters and closes the performance frame
+static void end_perf_frame(void) {
+    perf_frame_t* perf = perf_current();
+    uint64_t raster_ns;
+    display_take_counters(display, &raster_ns, &perf->dirty_cells);
+    perf_add_time(PERF_RASTER, raster_ns);
+    perf->audio_queued_bytes = audio_queued_bytes();
+    perf_end_frame(SDL_GetTicksNS());
+}
+
+static void update_speed_sample(uint64_t now) {
+    if (!cycling) {
+        speed_sample_start_ns = 0;
+        return;
+    }
+    if (speed_sample_start_ns == 0) {
+        speed_sample_start_ns = now;
+        speed_sample_frames = 0;
+    } else if (now - speed_sample_start_ns >= SPEED_SAMPLE_NS) {
+        speed_percent = (int)((uint64_t)speed_sample_frames * 100 * SDL_NS_PER_SECOND
+                              / ((now - speed_sample_start_ns) * timing_refresh_hz()));
+        speed_sample_start_ns = now;
+        speed_sample_frames = 0;
+        ui_dirty = true;
+    }
+}
+
+static void render_ui(void) {
+    uint64_t start = SDL_GetTicksNS();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    if (display_memory_viewer) memview_update(cpu->memory);
+    Clay_RenderCommandArray render_commands = App_Create_Layout();
+
+    // Upload whatever the render thread finished last; this never waits on it
+    uint64_t upload_start = SDL_GetTicksNS();
+    display_update(display, NULL);
+    uint64_t upload_end = SDL_GetTicksNS();
+
+    SDL_Clay_RenderClayCommands(renderer_data, &render_commands);
+
+    uint64_t present_start = SDL_GetTicksNS();
+    SDL_RenderPresent(renderer);
+
+    perf_add_time(PERF_UI, (upload_start - start) + (present_start - upload_end));
+    perf_add_time(PERF_UPLOAD, upload_end - upload_start);
+    perf_add_time(PERF_PRESENT, SDL_GetTicksNS() - present_start);
+}
+
+SDL_AppResult SDL_AppIterate(void *appstate) {
+    if (!cpu->running) {
+        return SDL_APP_SUCCESS;
+    }
+
+    uint64_t now = SDL_GetTicksNS();
+    if (!cycling) {
+        pacing = false;
+    } else {
+        if (!pacing) {
+            pacer_start(&emulation_pacer, timing_refresh_hz(), MAX_CATCH_UP_FRAMES, now);
+            pacing = true;
+            perf_restart(now);
+        }
+        // Each tick that is due runs speed-multiplier guest frames, all but the last skipped
+        uint32_t ticks = pacer_due(&emulation_pacer, now);
+        int multiplier = speed_multipliers[speed_index];
+        if (multiplier == 0) {
+            // Uncapped: run for a frame's time, then come straight back after the UI had its turn
+            run_guest_frames(0, now + timing_frame_ns());
+            end_perf_frame();
+            pacer_start(&emulation_pacer, timing_refresh_hz(), MAX_CATCH_UP_FRAMES, SDL_GetTicksNS());
+            ui_dirty = true;
+        } else if (ticks > 0) {
+            run_guest_frames(ticks * multiplier, 0);
+            end_perf_frame();
+            ui_dirty = true;
+        }
+    }
+    update_speed_sample(now);
+
+    // Events handled while paused (stepping, reset, loading a ROM) may have changed guest memory
+    if (sync_devices) {
+        sync_devices = false;
+        audio_update(cpu->memory);
+        if (!cycling) display_submit_frame(display);
+    }
+
+    if (!ui_dirty && display_frame_waiting(display)) ui_dirty = true;
+    if (always_redraw || (ui_dirty && now >= next_present_ns)) {
+        render_ui();
+        // A frame submitted just before still being rasterised has to be presented once it is done
+        ui_dirty = display_frame_waiting(display);
+        next_present_ns = now + present_interval_ns;
+    }
+    if (always_redraw) return SDL_APP_CONTINUE;
+
+    // Sleep until the next guest frame or present is due; an event ends the wait early
+    uint64_t wake = now + IDLE_WAIT_MS * SDL_NS_PER_MS;
+    bool frame_next = false;
+    if (cycling) {
+        wake = pacing ? pacer_next_ns(&emulation_pacer) : now;
+        frame_next = true;
+    }
+    if (ui_dirty && next_present_ns < wake) {
+        wake = next_present_ns;
+        frame_next = false;
+    }
+    // The render thread does not wake the loop when it finishes, so poll for it instead
+    if (display_frame_waiting(display) && now + RENDER_POLL_NS < wake) {
+        wake = now + RENDER_POLL_NS;
+        frame_next = false;
+    }
+    now = SDL_GetTicksNS();
+    if (wake > now) {
+        uint64_t remaining = wake - now;
+        if (!frame_next) {
+            SDL_WaitEventTimeout(NULL, (Sint32)(remaining / SDL_NS_PER_MS));
+        } else if (remaining > PRECISE_WAIT_NS) {
+            // Wake up short of the frame; the next iteration sleeps the rest precisely
+            SDL_WaitEventTimeout(NULL, (Sint32)((remaining - PRECISE_WAIT_NS) / SDL_NS_PER_MS) + 1);
+        } else {
+            SDL_DelayPrecise(remaining);
+        }
+    }
 
     return SDL_APP_CONTINUE;
 }
 
 /* This function runs once at shutdown. */
 void SDL_AppQuit(void *appstate, SDL_AppResult result) {
+    if (profiler_enabled()) profiler_print_report(stdout, cpu, PROFILE_REPORT_ROWS);
+    if (profile_stacks_path) profiler_write_collapsed(profile_stacks_path);
+    trace_stream_close();
+    perf_log_close();
+    if (coverage_path) coverage_save(coverage_data(), coverage_path);
+    plugin_unload_all();
     display_destroy(display);
     cpu_destroy(cpu);
     if (fonts) {
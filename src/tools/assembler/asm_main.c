@@ -77,6 +77,16 @@ int internal_assemble(const char* filein, const char* fileout) {
     // Write out .bin with resolved labels
     finalize_output(fileout);
 
+    // Labels next to the ROM, so the profiler can report by label
+    char symfile[1024];
+    snprintf(symfile, sizeof(symfile), "%s.sym", fileout);
+    write_symbol_file(symfile);
+
+    // Word to source line map, for coverage reports
+    char linefile[1024];
+    snprintf(linefile, sizeof(linefile), "%s.lines", fileout);
+    write_line_map(linefile, filein);
+
     // Clean up label table
     free_symbols();
     
@@ -8,6 +8,7 @@
 #define MAX_INSNS 16384
 
 static uint16_t output[MAX_INSNS];
+static int source_lines[MAX_INSNS]; // Source line of each word, 0 if unknown
 
 typedef struct {
     int pc_index;
@@ -132,6 +133,25 @@ void emit_special_format(uint16_t pc, uint8_t opcode, uint8_t rd, uint8_t misc,
     isnt_cnt = (pc / 2) + 1;
 }
 
+void emit_reglist_format(uint16_t pc, uint8_t pop, uint16_t regs, int line_num) {
+    if (pc >= MAX_INSNS) {
+        fprintf(stderr, "Error: Max instruction count reached. (Defined in tools/assembler/codegen.c)\n");
+        exit(1);
+    }
+    if (regs & ((1 << 0) | (1 << 6))) {
+        fprintf(stderr, "Error on line %d: PUSHM/POPM register list cannot contain r0 or sp\n", line_num);
+        exit(1);
+    }
+    // r1..r5 map to list bits 0..4 and ra to bit 5, placed in bits 7-2 of the instruction
+    uint16_t list = ((regs >> 1) & 0x1F) | (((regs >> 7) & 1) << 5);
+    uint16_t insn = (0b11111 << 11)
+                  | ((pop ? 1 : 0) << 10)
+                  | (list << 2)
+                  | 0b11;
+    output[pc/2] = insn;
+    isnt_cnt = (pc / 2) + 1;
+}
+
 void emit_imm_format_identifier(uint16_t pc, uint8_t opcode, uint8_t rd, uint8_t rs1, const char* var_name, int line_num) {
     if (pc >= MAX_INSNS) {
         fprintf(stderr, "Error: Max instruction count reached. (Defined in tools/assembler/codegen.c)\n");
@@ -325,6 +345,28 @@ void finalize_output(const char* filename) {
     fclose(f);
 }
 
+void map_source_line(uint16_t start_pc, uint16_t end_pc, int line_num) {
+    for (int i = start_pc / 2; i < end_pc / 2 && i < MAX_INSNS; i++) {
+        source_lines[i] = line_num;
+    }
+}
+
+bool write_line_map(const char* filename, const char* source) {
+    FILE* f = fopen(filename, "w");
+    if (!f) {
+        fprintf(stderr, "Error: Unable to write line map \"%s\"\n", filename);
+        return false;
+    }
+    fprintf(f, "source %s\n", source);
+    for (int i = 0; i < isnt_cnt; i++) {
+        if (source_lines[i] > 0) {
+            fprintf(f, "%04X %d\n", i * 2, source_lines[i]);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
 void emit_push_pseudo(uint16_t pc, uint8_t reg) {
     // PUSH reg expands to:
     // 1. ADDI sp, sp, -2  - Decrement stack pointer
@@ -354,9 +396,10 @@ void reset_codegen(void) {
     symbol_cnt = 0;
     isnt_cnt = 0;
     
-    // Clear output array
+    // Clear output array and line map
     for (int i = 0; i < MAX_INSNS; i++) {
         output[i] = 0;
+        source_lines[i] = 0;
     }
     
     // Clear references array
@@ -49,10 +49,14 @@ void yyerror(const char *s);
 %token <pc> LDI LDW STW ADDI LUI ANDI ORI XORI
 %token <pc> JMP JEQ JNE JGT JLT JSR RET
 %token <pc> HLT INC DEC LDB STB
+%token <pc> MUL MULH DIV MOD ADC SBC
+%token <pc> PUSHM POPM
 %token <pc> LOAD16 PUSH POP
 %token <nops> NOP
 %token NEWLINE
 
+%type <num> reg_list
+
 %left IMM5 IMM8 OFFSET IMM16
 %right NEWLINE
 %%
@@ -159,6 +163,20 @@ instruction:
   | LDB REG ',' '[' REG IMM5 ']'                  { emit_special_format($1, 0b11100, $2, $5, $6); }
   | LDB REG ',' '[' REG '-' IDENTIFIER ']'        { emit_special_format_neg_identifier($1, 0b11100, $2, $5, $7.name, yylineno); }
   | LDB REG ',' '[' REG ']'                       { emit_special_format($1, 0b11100, $2, $5, 0); }
+
+  | MUL  REG ',' REG ',' REG                      { emit_reg_format($1, 0b11110, $2, $4, $6, 0); } // func=00
+  | MULH REG ',' REG ',' REG                      { emit_reg_format($1, 0b11110, $2, $4, $6, 1); } // func=01
+  | DIV  REG ',' REG ',' REG                      { emit_reg_format($1, 0b11110, $2, $4, $6, 2); } // func=10
+  | MOD  REG ',' REG ',' REG                      { emit_reg_format($1, 0b11110, $2, $4, $6, 3); } // func=11
+  | ADC  REG ',' REG ',' REG                      { emit_reg_format($1, 0b11111, $2, $4, $6, 0); } // func=00
+  | SBC  REG ',' REG ',' REG                      { emit_reg_format($1, 0b11111, $2, $4, $6, 1); } // func=01
+
+  | LDB REG ',' '[' REG ']' '+'                   { emit_reg_format($1, 0b11111, $2, $5, 0b000, 2); } // func=10
+  | STB REG ',' '[' REG ']' '+'                   { emit_reg_format($1, 0b11111, $2, $5, 0b001, 2); } // func=10
+  | LDW REG ',' '[' REG ']' '+'                   { emit_reg_format($1, 0b11111, $2, $5, 0b010, 2); } // func=10
+  | STW REG ',' '[' REG ']' '+'                   { emit_reg_format($1, 0b11111, $2, $5, 0b011, 2); } // func=10
+  | PUSHM reg_list                                { emit_reglist_format($1, 0, $2, yylineno); }
+  | POPM  reg_list                                { emit_reglist_format($1, 1, $2, yylineno); }
   
   | LOAD16 REG ',' IMM16                          { emit_imm_format_with_line($1, 0b01000, $2, 0, $4.lower, yylineno); emit_imm_format_with_line($1 + 2, 0b01100, $2, 0, $4.upper, yylineno);}
   | LOAD16 REG ',' OFFSET                         { emit_imm_format_with_line($1, 0b01000, $2, 0, $4 & 0xFF, yylineno); emit_imm_format_with_line($1 + 2, 0b01100, $2, 0, $4 >> 8, yylineno);}
@@ -170,6 +188,11 @@ instruction:
   | POP REG                                       { emit_pop_pseudo($1, $2); }
 ;
 
+reg_list:
+    REG                                           { $$ = 1 << $1; }
+  | reg_list ',' REG                              { $$ = $1 | (1 << $3); }
+;
+
 %%
 
 void yyerror(const char *s) {
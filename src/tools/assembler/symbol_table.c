@@ -56,6 +56,40 @@ int get_symbol(const char* name, int* type) {
     exit(1);
 }
 
+// Comparison function for qsort - orders Symbol pointers by value
+int symbol_value_compare(const void *a, const void *b) {
+    Symbol* s1 = *(Symbol**)a;
+    Symbol* s2 = *(Symbol**)b;
+    return (s1->value > s2->value) - (s1->value < s2->value);
+}
+
+bool write_symbol_file(const char* filename) {
+    FILE* f = fopen(filename, "w");
+    if (!f) {
+        fprintf(stderr, "Error: Unable to write symbol file \"%s\"\n", filename);
+        return false;
+    }
+    // Only labels are addresses; assignments are plain constants
+    Symbol** labels = malloc(sizeof(Symbol*) * (symbol_cnt ? symbol_cnt : 1));
+    if (!labels) {
+        perror("malloc");
+        exit(1);
+    }
+    int label_cnt = 0;
+    for (int i = 0; i < symbol_cnt; i++) {
+        if (symbols[i]->type == 0) {
+            labels[label_cnt++] = symbols[i];
+        }
+    }
+    qsort(labels, label_cnt, sizeof(Symbol*), symbol_value_compare);
+    for (int i = 0; i < label_cnt; i++) {
+        fprintf(f, "%04X %s\n", labels[i]->value & 0xFFFF, labels[i]->name);
+    }
+    free(labels);
+    fclose(f);
+    return true;
+}
+
 void free_symbols(void) {
     for (int i = 0; i < symbol_cnt; i++) {
         Symbol* s = symbols[i];
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "idn16/coverage.h"
+
+#define MAX_SOURCE_LINES 16384
+
+static coverage_t merged;
+static int line_of[MEMORY_SIZE / 2];  // Source line of each word, 0 if none
+
+
+static void usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-o merged.cov] [-l program.bin.lines] <run.cov>...\n", name);
+}
+
+// Reads the "source <path>" header and the "<address> <line>" entries of an assembler line map
+static bool load_line_map(const char* path, char* source, size_t size) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror("Error opening line map");
+        return false;
+    }
+    char line[1024];
+    if (!fgets(line, sizeof(line), file) || strncmp(line, "source ", 7) != 0) {
+        fprintf(stderr, "%s is not an IDN-16 line map\n", path);
+        fclose(file);
+        return false;
+    }
+    snprintf(source, size, "%.*s", (int)strcspn(line + 7, "\r\n"), line + 7);
+
+    unsigned int address;
+    int line_num;
+    while (fscanf(file, "%x %d", &address, &line_num) == 2) {
+        if (address < MEMORY_SIZE && line_num > 0) line_of[address / 2] = line_num;
+    }
+    fclose(file);
+    return true;
+}
+
+// Prints the source with gcov-style markers: "-" has no code, "#####" never ran,
+// "+" ran; branches are tagged with the directions seen
+static bool print_annotated(const char* source) {
+    static uint8_t code[MAX_SOURCE_LINES], ran[MAX_SOURCE_LINES];
+    static uint8_t taken[MAX_SOURCE_LINES], not_taken[MAX_SOURCE_LINES], branch[MAX_SOURCE_LINES];
+    int code_lines = 0, ran_lines = 0;
+
+    for (int slot = 0; slot < MEMORY_SIZE / 2; slot++) {
+        int n = line_of[slot];
+        if (n <= 0 || n >= MAX_SOURCE_LINES) continue;
+        uint16_t address = slot * 2;
+        code[n] = 1;
+        if (coverage_test(merged.executed, address)) ran[n] = 1;
+        if (coverage_test(merged.taken, address)) taken[n] = branch[n] = 1;
+        if (coverage_test(merged.not_taken, address)) not_taken[n] = branch[n] = 1;
+    }
+
+    FILE* file = fopen(source, "r");
+    if (!file) {
+        perror("Error opening source file");
+        return false;
+    }
+    char line[1024];
+    int n = 0;
+    while (fgets(line, sizeof(line), file)) {
+        n++;
+        const char* mark = "-";
+        const char* tag = "";
+        if (n < MAX_SOURCE_LINES && code[n]) {
+            code_lines++;
+            mark = ran[n] ? "+" : "#####";
+            if (ran[n]) ran_lines++;
+            if (branch[n]) {
+                tag = taken[n] && not_taken[n] ? "[both]" : taken[n] ? "[taken]" : "[not taken]";
+            }
+        }
+        printf("%6s %-11s %5d: %s", mark, tag, n, line);
+        if (!strchr(line, '\n')) printf("\n");
+    }
+    fclose(file);
+    printf("\n%s: %d of %d lines with code executed\n", source, ran_lines, code_lines);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const char* output = NULL;
+    const char* line_map = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "o:l:")) != -1) {
+        switch (opt) {
+        case 'o': output = optarg; break;
+        case 'l': line_map = optarg; break;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // Merge every run
+    for (int i = optind; i < argc; i++) {
+        if (!coverage_load_merge(&merged, argv[i])) return 1;
+    }
+    if (output && !coverage_save(&merged, output)) return 1;
+
+    // Summary
+    int executed = 0, both = 0, taken_only = 0, not_taken_only = 0;
+    for (int slot = 0; slot < MEMORY_SIZE / 2; slot++) {
+        uint16_t address = slot * 2;
+        if (coverage_test(merged.executed, address)) executed++;
+        bool taken = coverage_test(merged.taken, address);
+        bool not_taken = coverage_test(merged.not_taken, address);
+        if (taken && not_taken) both++;
+        else if (taken) taken_only++;
+        else if (not_taken) not_taken_only++;
+    }
+    printf("%d runs merged, %d instruction words executed\n", argc - optind, executed);
+    printf("Branches: %d both ways, %d only taken, %d never taken\n", both, taken_only, not_taken_only);
+
+    if (line_map) {
+        char source[1024];
+        if (!load_line_map(line_map, source, sizeof(source))) return 1;
+        printf("\n");
+        if (!print_annotated(source)) return 1;
+    }
+    return 0;
+}
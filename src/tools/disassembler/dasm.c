@@ -56,12 +56,15 @@ char* disassemble_word(uint16_t word) {
         pc += 2;
         return result;
         case 0b00110:
+            // func 10 and 11 are not assigned; the CPU rejects them
+            if (func > 1) break;
             if (func == 0) sprintf(result, "SHR  r%d, r%d, r%d\n", rd, rs1, rs2);
             else          sprintf(result, "SRA  r%d, r%d, r%d\n", rd, rs1, rs2);
             
             pc += 2;
             return result;
         case 0b00111:
+            if (func == 3) break;
             if (func == 0) sprintf(result, "MOV  r%d, r%d\n", rd, rs1);
             else if (func == 1) sprintf(result, "CMP  r%d, r%d\n", rd, rs1);
             else                sprintf(result, "NOT  r%d, r%d\n", rd, rs1);
@@ -186,6 +189,44 @@ char* disassemble_word(uint16_t word) {
         case 0b11101: sprintf(result, "STB  r%d, [r%d+%d]\n", rd, rs1, imm); 
         pc += 2;
         return result;
+        case 0b11110: {
+            uint8_t rs2 = (word >> 2) & 0x07;
+            static const char* const names[4] = { "MUL ", "MULH", "DIV ", "MOD " };
+            sprintf(result, "%s r%d, r%d, r%d\n", names[word & 0x03], rd, rs1, rs2);
+            pc += 2;
+            return result;
+        }
+        case 0b11111: {
+            uint8_t rs2 = (word >> 2) & 0x07;
+            if ((word & 0x03) == 0) {
+                sprintf(result, "ADC  r%d, r%d, r%d\n", rd, rs1, rs2);
+                pc += 2;
+                return result;
+            } else if ((word & 0x03) == 1) {
+                sprintf(result, "SBC  r%d, r%d, r%d\n", rd, rs1, rs2);
+                pc += 2;
+                return result;
+            } else if ((word & 0x03) == 2 && rs2 <= 3) {
+                static const char* const names[4] = { "LDB ", "STB ", "LDW ", "STW " };
+                sprintf(result, "%s r%d, [r%d]+\n", names[rs2], rd, rs1);
+                pc += 2;
+                return result;
+            } else if ((word & 0x03) == 3 && (word & 0x0300) == 0) {
+                // Register list in bits 7-2: r1..r5, then ra
+                int len = sprintf(result, (word & 0x0400) ? "POPM" : "PUSHM");
+                const char* sep = " ";
+                for (int bit = 0; bit < 6; bit++) {
+                    if (word & (1 << (bit + 2))) {
+                        len += sprintf(result + len, "%sr%d", sep, bit == 5 ? 7 : bit + 1);
+                        sep = ", ";
+                    }
+                }
+                sprintf(result + len, "\n");
+                pc += 2;
+                return result;
+            }
+            break;
+        }
         }
     }
 
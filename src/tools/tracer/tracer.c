@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "idn16/trace.h"
+#include "idn16/labels.h"
+
+
+int main(int argc, char *argv[]) {
+    if (argc > 3 || argc < 2) {
+        fprintf(stderr, "Usage: %s <input.trace> <optional_symbols.sym>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *file = fopen(argv[1], "rb");
+    if (!file) {
+        perror("Error opening file");
+        return 1;
+    }
+    if (!trace_read_header(file)) {
+        fprintf(stderr, "%s is not an IDN-16 trace (version %d)\n", argv[1], TRACE_VERSION);
+        fclose(file);
+        return 1;
+    }
+
+    if (argc == 3 && !labels_load(argv[2])) {
+        perror("Error opening symbol file");
+        fclose(file);
+        return 1;
+    }
+
+    // Decode every record
+    trace_record_t prev = {0};
+    trace_record_t record;
+    unsigned long count = 0;
+    char line[TRACE_LINE_LENGTH];
+    while (trace_read_record(file, &prev, &record)) {
+        trace_format(&record, line, sizeof(line));
+        printf("%s\n", line);
+        count++;
+    }
+    fclose(file);
+    fprintf(stderr, "%lu instructions\n", count);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+#include "idn16/breakpoints.h"
+#include "test_programs.h"
+#include <stdio.h>
+
+static Cpu_t* cpu;
+
+void setUp(void) {
+    cpu = cpu_init();
+    TEST_ASSERT_NOT_NULL(cpu);
+    breakpoints_clear_all();
+}
+
+void tearDown(void) {
+    cpu_destroy(cpu);
+}
+
+// Runs like the emulator loop; returns true if a breakpoint stopped it
+static bool run_until_break(bool resuming) {
+    for (int i = 0; i < 100 && cpu->running; i++) {
+        if (!resuming && breakpoints_check(cpu)) return true;
+        resuming = false;
+        cpu_cycle(cpu);
+    }
+    return false;
+}
+
+void test_breakpoint_bitmap(void) {
+    TEST_ASSERT_FALSE(breakpoints_active());
+    TEST_ASSERT_TRUE(breakpoint_set(0x0010, NULL));
+    TEST_ASSERT_TRUE(breakpoint_at(0x0010));
+    TEST_ASSERT_FALSE(breakpoint_at(0x0012));
+    TEST_ASSERT_TRUE(breakpoints_active());
+
+    TEST_ASSERT_FALSE(breakpoint_toggle(0x0010));
+    TEST_ASSERT_FALSE(breakpoint_at(0x0010));
+    TEST_ASSERT_FALSE(breakpoints_active());
+    TEST_ASSERT_TRUE(breakpoint_toggle(0x0010));
+    TEST_ASSERT_TRUE(breakpoint_clear(0x0010));
+    TEST_ASSERT_FALSE(breakpoint_clear(0x0010));
+}
+
+void test_breakpoint_stops_before_instruction(void) {
+    load_countdown(cpu);
+    breakpoint_set(0x0006, NULL);
+
+    TEST_ASSERT_TRUE(run_until_break(false));
+    TEST_ASSERT_EQUAL_HEX16(0x0006, cpu->pc);
+    TEST_ASSERT_EQUAL_HEX16(2, cpu->r[1]);
+    TEST_ASSERT_EQUAL_INT(BREAK_PC, breakpoints_last_hit()->reason);
+
+    // Resuming runs the breakpoint's instruction and stops there next time round
+    TEST_ASSERT_TRUE(run_until_break(true));
+    TEST_ASSERT_EQUAL_HEX16(1, cpu->r[1]);
+}
+
+void test_conditional_breakpoint(void) {
+    load_countdown(cpu);
+    TEST_ASSERT_TRUE(breakpoint_set(0x0006, "r1 == 0"));
+
+    TEST_ASSERT_TRUE(run_until_break(false));
+    TEST_ASSERT_EQUAL_HEX16(0x0006, cpu->pc);
+    TEST_ASSERT_EQUAL_HEX16(0, cpu->r[1]);
+
+    // Invalid conditions set nothing
+    TEST_ASSERT_FALSE(breakpoint_set(0x0000, "r9 == 0"));
+    TEST_ASSERT_FALSE(breakpoint_set(0x0000, "r1 = 0"));
+    TEST_ASSERT_FALSE(breakpoint_at(0x0000));
+}
+
+void test_condition_compile(void) {
+    break_condition_t condition;
+    TEST_ASSERT_TRUE(breakpoint_compile("[0x8000]>=0x10", &condition));
+    TEST_ASSERT_EQUAL_INT(COND_MEMORY, condition.operand);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, condition.address);
+    TEST_ASSERT_EQUAL_INT(COND_GE, condition.op);
+    TEST_ASSERT_EQUAL_HEX16(0x10, condition.value);
+
+    memory_write_word(cpu->memory, 0x8000, 0x10, false);
+    TEST_ASSERT_TRUE(breakpoint_condition_holds(&condition, cpu));
+    memory_write_word(cpu->memory, 0x8000, 0x0F, false);
+    TEST_ASSERT_FALSE(breakpoint_condition_holds(&condition, cpu));
+
+    // A flag alone tests it is set
+    TEST_ASSERT_TRUE(breakpoint_compile("z", &condition));
+    cpu->flags.z = 1;
+    TEST_ASSERT_TRUE(breakpoint_condition_holds(&condition, cpu));
+
+    TEST_ASSERT_TRUE(breakpoint_compile("sp < 0xCFFE", &condition));
+    TEST_ASSERT_FALSE(breakpoint_condition_holds(&condition, cpu));
+    TEST_ASSERT_FALSE(breakpoint_compile("r1 == ", &condition));
+}
+
+void test_watchpoint_write(void) {
+    load_countdown(cpu);
+    TEST_ASSERT_TRUE(watchpoint_set(RAM_START, 2, WATCH_WRITE));
+
+    TEST_ASSERT_TRUE(run_until_break(false));
+    const break_hit_t* hit = breakpoints_last_hit();
+    TEST_ASSERT_EQUAL_INT(BREAK_WATCH, hit->reason);
+    TEST_ASSERT_EQUAL_HEX16(0x0004, hit->pc);
+    TEST_ASSERT_EQUAL_HEX16(RAM_START, hit->address);
+    TEST_ASSERT_TRUE(hit->write);
+
+    // Read watchpoints and other pages do not stop writes
+    breakpoints_clear_all();
+    watchpoint_set(RAM_START, 2, WATCH_READ);
+    watchpoint_set(RAM_START + WATCH_PAGE_SIZE, 2, WATCH_WRITE);
+    TEST_ASSERT_FALSE(run_until_break(true));
+    TEST_ASSERT_FALSE(cpu->running);
+}
+
+void test_watchpoint_range_overlap(void) {
+    // STW r1, [r2+0] writing the second byte of a word watch
+    memory_write_word(cpu->memory, 0x0000, 0x5140, true);
+    cpu->r[2] = RAM_START;
+    watchpoint_set(RAM_START + 1, 1, WATCH_WRITE);
+    TEST_ASSERT_TRUE(breakpoints_check(cpu));
+
+    TEST_ASSERT_TRUE(watchpoint_clear(RAM_START + 1));
+    TEST_ASSERT_FALSE(breakpoints_active());
+    TEST_ASSERT_FALSE(watchpoint_set(0xFFFF, 2, WATCH_WRITE));
+}
+
+void test_breakpoint_commands(void) {
+    TEST_ASSERT_TRUE(breakpoints_command("break 0x0010"));
+    TEST_ASSERT_TRUE(breakpoints_command("break 0x0020 if r1 != 5"));
+    TEST_ASSERT_TRUE(breakpoints_command("watch 0x8000 4 rw"));
+    TEST_ASSERT_TRUE(breakpoint_at(0x0010));
+    TEST_ASSERT_TRUE(breakpoint_at(0x0020));
+
+    TEST_ASSERT_TRUE(breakpoints_command("delete 0x0010"));
+    TEST_ASSERT_FALSE(breakpoint_at(0x0010));
+    TEST_ASSERT_FALSE(breakpoints_command("delete 0x0010"));
+    TEST_ASSERT_FALSE(breakpoints_command("break nowhere"));
+    TEST_ASSERT_FALSE(breakpoints_command("watch 0x8000 2 x"));
+    TEST_ASSERT_FALSE(breakpoints_command("jump 0x0010"));
+
+    TEST_ASSERT_TRUE(breakpoints_command("clear"));
+    TEST_ASSERT_FALSE(breakpoints_active());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_breakpoint_bitmap);
+    RUN_TEST(test_breakpoint_stops_before_instruction);
+    RUN_TEST(test_conditional_breakpoint);
+    RUN_TEST(test_condition_compile);
+    RUN_TEST(test_watchpoint_write);
+    RUN_TEST(test_watchpoint_range_overlap);
+    RUN_TEST(test_breakpoint_commands);
+    return UNITY_END();
+}
@@ -0,0 +1,92 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+#include "idn16/coverage.h"
+#include "test_programs.h"
+#include <stdio.h>
+#include <string.h>
+
+static Cpu_t* cpu;
+
+void setUp(void) {
+    cpu = cpu_init();
+    TEST_ASSERT_NOT_NULL(cpu);
+    coverage_reset();
+}
+
+void tearDown(void) {
+    cpu_destroy(cpu);
+}
+
+void test_coverage_records_executed_and_branches(void) {
+    load_countdown(cpu);
+    run_until_halt(cpu, cpu_cycle_covered, 100);
+    coverage_t* data = coverage_data();
+
+    for (uint16_t pc = 0; pc < COUNTDOWN_LENGTH * 2; pc += 2) {
+        TEST_ASSERT_TRUE(coverage_test(data->executed, pc));
+    }
+    TEST_ASSERT_FALSE(coverage_test(data->executed, COUNTDOWN_LENGTH * 2));
+
+    // The JNE loops twice and then falls through
+    TEST_ASSERT_TRUE(coverage_test(data->taken, 0x0006));
+    TEST_ASSERT_TRUE(coverage_test(data->not_taken, 0x0006));
+
+    // Only conditional branches get branch bits
+    TEST_ASSERT_FALSE(coverage_test(data->taken, 0x0002));
+    TEST_ASSERT_FALSE(coverage_test(data->not_taken, 0x0002));
+}
+
+void test_coverage_branch_one_way(void) {
+    // LDI r1, 0; JNE +2 never jumps
+    memory_write_word(cpu->memory, 0x0000, 0x4100, true);
+    memory_write_word(cpu->memory, 0x0002, 0x9002, true);
+    memory_write_word(cpu->memory, 0x0004, 0xC000, true);
+    for (int i = 0; i < 10 && cpu->running; i++) {
+        cpu_cycle_covered(cpu);
+    }
+    coverage_t* data = coverage_data();
+    TEST_ASSERT_FALSE(coverage_test(data->taken, 0x0002));
+    TEST_ASSERT_TRUE(coverage_test(data->not_taken, 0x0002));
+}
+
+void test_coverage_save_and_merge(void) {
+    const char* path = "test_coverage.cov";
+    coverage_record(0x0010, 0xC000, 0x0012);
+    TEST_ASSERT_TRUE(coverage_save(coverage_data(), path));
+
+    static coverage_t merged;
+    memset(&merged, 0, sizeof(merged));
+    merged.executed[0] = 0x01;
+    TEST_ASSERT_TRUE(coverage_load_merge(&merged, path));
+    remove(path);
+
+    TEST_ASSERT_TRUE(coverage_test(merged.executed, 0x0000));
+    TEST_ASSERT_TRUE(coverage_test(merged.executed, 0x0010));
+    TEST_ASSERT_FALSE(coverage_test(merged.executed, 0x0012));
+}
+
+void test_coverage_rejects_other_files(void) {
+    const char* path = "test_coverage_bad.cov";
+    FILE* file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs("IDN16TRC", file);
+    fclose(file);
+
+    static coverage_t merged;
+    memset(&merged, 0, sizeof(merged));
+    TEST_ASSERT_FALSE(coverage_load_merge(&merged, path));
+    TEST_ASSERT_FALSE(coverage_load_merge(&merged, "does_not_exist.cov"));
+    remove(path);
+
+    TEST_ASSERT_FALSE(coverage_test(merged.executed, 0x0000));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_coverage_records_executed_and_branches);
+    RUN_TEST(test_coverage_branch_one_way);
+    RUN_TEST(test_coverage_save_and_merge);
+    RUN_TEST(test_coverage_rejects_other_files);
+    return UNITY_END();
+}
@@ -376,6 +376,176 @@ void test_LDB_and_STB(void) {
     TEST_ASSERT_EQUAL_UINT16(0xCD, cpu->r[3]);
 }
 
+void test_MUL_and_MULH(void) {
+    cpu->r[1] = 300; cpu->r[2] = 7;
+    mul(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(2100, cpu->r[3]);
+    TEST_ASSERT_FALSE(cpu->flags.c);
+    TEST_ASSERT_FALSE(cpu->flags.v);
+
+    // Edge: product does not fit in 16 bits
+    cpu->r[1] = 0x1234; cpu->r[2] = 0x0100;
+    mul(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x3400, cpu->r[3]);
+    TEST_ASSERT_TRUE(cpu->flags.c);
+    TEST_ASSERT_TRUE(cpu->flags.v);
+    mulh(4, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x0012, cpu->r[4]);
+
+    // Signed high word: -2 * 0x4000 = 0xFFFF8000
+    cpu->r[1] = 0xFFFE; cpu->r[2] = 0x4000;
+    mulh(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, cpu->r[3]);
+    TEST_ASSERT_TRUE(cpu->flags.n);
+
+    // Edge: mul to r0 (should not change r0)
+    mul(0, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x0000, cpu->r[0]);
+}
+
+void test_DIV_and_MOD(void) {
+    cpu->r[1] = 1000; cpu->r[2] = 7;
+    divu(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(142, cpu->r[3]);
+    modu(4, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(6, cpu->r[4]);
+    TEST_ASSERT_FALSE(cpu->flags.v);
+
+    // Unsigned: 0xFFFF / 2
+    cpu->r[1] = 0xFFFF; cpu->r[2] = 2;
+    divu(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x7FFF, cpu->r[3]);
+
+    // Edge: divide by zero gives 0 and sets V
+    cpu->r[2] = 0;
+    divu(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[3]);
+    TEST_ASSERT_TRUE(cpu->flags.v);
+    TEST_ASSERT_TRUE(cpu->flags.z);
+    modu(4, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[4]);
+    TEST_ASSERT_TRUE(cpu->flags.v);
+}
+
+void test_ADC_and_SBC(void) {
+    // 32-bit add: 0x0001FFFF + 0x00000001 in (r2:r1) + (r4:r3)
+    cpu->r[1] = 0xFFFF; cpu->r[2] = 0x0001;
+    cpu->r[3] = 0x0001; cpu->r[4] = 0x0000;
+    add(1, 1, 3, cpu);
+    adc(2, 2, 4, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x0000, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0002, cpu->r[2]);
+    TEST_ASSERT_FALSE(cpu->flags.c);
+
+    // 32-bit subtract: 0x00020000 - 0x00000001
+    cpu->r[1] = 0x0000; cpu->r[2] = 0x0002;
+    cpu->r[3] = 0x0001; cpu->r[4] = 0x0000;
+    sub(1, 1, 3, cpu);
+    TEST_ASSERT_FALSE(cpu->flags.c);
+    sbc(2, 2, 4, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x0001, cpu->r[2]);
+    TEST_ASSERT_TRUE(cpu->flags.c);
+
+    // Edge: carry out of adc and signed overflow
+    cpu->flags.c = 1;
+    cpu->r[1] = 0x7FFF; cpu->r[2] = 0x0000;
+    adc(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x8000, cpu->r[3]);
+    TEST_ASSERT_TRUE(cpu->flags.v);
+    TEST_ASSERT_FALSE(cpu->flags.c);
+
+    // Edge: sbc borrowing through zero
+    cpu->flags.c = 0;
+    cpu->r[1] = 0x0000; cpu->r[2] = 0x0000;
+    sbc(3, 1, 2, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, cpu->r[3]);
+    TEST_ASSERT_FALSE(cpu->flags.c);
+}
+
+void test_decode_SP_arithmetic(void) {
+    // MUL r3, r1, r2
+    shared i = decode((0b11110 << 11) | (3 << 8) | (1 << 5) | (2 << 2) | 0);
+    TEST_ASSERT_EQUAL_UINT16(MUL, i.inst);
+    TEST_ASSERT_EQUAL_UINT16(3, i.first);
+    TEST_ASSERT_EQUAL_UINT8(1, i.second);
+    TEST_ASSERT_EQUAL_UINT8(2, i.third);
+    i = decode((0b11110 << 11) | (3 << 8) | (1 << 5) | (2 << 2) | 3);
+    TEST_ASSERT_EQUAL_UINT16(MOD, i.inst);
+    i = decode((0b11111 << 11) | (3 << 8) | (1 << 5) | (2 << 2) | 1);
+    TEST_ASSERT_EQUAL_UINT16(SBC, i.inst);
+}
+
+void test_post_increment_load_store(void) {
+    cpu->r[1] = RAM_START + 0x200;
+    cpu->r[2] = 'H';
+    stb_post(2, 1, cpu);
+    cpu->r[2] = 'i';
+    stb_post(2, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16(RAM_START + 0x202, cpu->r[1]);
+
+    cpu->r[1] = RAM_START + 0x200;
+    ldb_post(3, 1, cpu);
+    ldb_post(4, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16('H', cpu->r[3]);
+    TEST_ASSERT_EQUAL_UINT16('i', cpu->r[4]);
+    TEST_ASSERT_EQUAL_UINT16(RAM_START + 0x202, cpu->r[1]);
+
+    // Words advance the pointer by 2
+    cpu->r[1] = RAM_START + 0x210;
+    cpu->r[2] = 0xBEEF;
+    stw_post(2, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16(RAM_START + 0x212, cpu->r[1]);
+    cpu->r[1] = RAM_START + 0x210;
+    ldw_post(3, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, cpu->r[3]);
+    TEST_ASSERT_TRUE(cpu->flags.n);
+    TEST_ASSERT_EQUAL_UINT16(RAM_START + 0x212, cpu->r[1]);
+
+    // Edge: loading into the pointer register keeps the loaded value
+    cpu->r[1] = RAM_START + 0x210;
+    ldw_post(1, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, cpu->r[1]);
+
+    // Edge: load into r0 still advances the pointer
+    cpu->r[1] = RAM_START + 0x200;
+    ldb_post(0, 1, cpu);
+    TEST_ASSERT_EQUAL_UINT16(0x0000, cpu->r[0]);
+    TEST_ASSERT_EQUAL_UINT16(RAM_START + 0x201, cpu->r[1]);
+}
+
+void test_PUSHM_and_POPM(void) {
+    uint16_t sp = cpu->r[6];
+    cpu->r[1] = 0x1111; cpu->r[2] = 0x2222; cpu->r[7] = 0x7777;
+
+    // List bits: r1 = bit 0, r2 = bit 1, ra = bit 5
+    pushm(0b100011, cpu);
+    TEST_ASSERT_EQUAL_UINT16(sp - 6, cpu->r[6]);
+    // Same layout as PUSH r1, PUSH r2, PUSH ra
+    TEST_ASSERT_EQUAL_UINT16(0x1111, memory_read_word(cpu->memory, sp - 2));
+    TEST_ASSERT_EQUAL_UINT16(0x2222, memory_read_word(cpu->memory, sp - 4));
+    TEST_ASSERT_EQUAL_UINT16(0x7777, memory_read_word(cpu->memory, sp - 6));
+
+    cpu->r[1] = 0; cpu->r[2] = 0; cpu->r[7] = 0;
+    popm(0b100011, cpu);
+    TEST_ASSERT_EQUAL_UINT16(sp, cpu->r[6]);
+    TEST_ASSERT_EQUAL_UINT16(0x1111, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(0x2222, cpu->r[2]);
+    TEST_ASSERT_EQUAL_UINT16(0x7777, cpu->r[7]);
+}
+
+void test_decode_post_increment_and_reglist(void) {
+    // LDW r3, [r1]+
+    shared i = decode((0b11111 << 11) | (3 << 8) | (1 << 5) | (0b010 << 2) | 0b10);
+    TEST_ASSERT_EQUAL_UINT16(LDWP, i.inst);
+    TEST_ASSERT_EQUAL_UINT16(3, i.first);
+    TEST_ASSERT_EQUAL_UINT8(1, i.second);
+    // POPM r1, ra
+    i = decode((0b11111 << 11) | (1 << 10) | (0b100001 << 2) | 0b11);
+    TEST_ASSERT_EQUAL_UINT16(POPM, i.inst);
+    TEST_ASSERT_EQUAL_UINT16(0b100001, i.first);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_ADD);
@@ -404,5 +574,12 @@ int main(void) {
     RUN_TEST(test_INC_and_DEC);
     RUN_TEST(test_LUI);
     RUN_TEST(test_LDB_and_STB);
+    RUN_TEST(test_MUL_and_MULH);
+    RUN_TEST(test_DIV_and_MOD);
+    RUN_TEST(test_ADC_and_SBC);
+    RUN_TEST(test_decode_SP_arithmetic);
+    RUN_TEST(test_post_increment_load_store);
+    RUN_TEST(test_PUSHM_and_POPM);
+    RUN_TEST(test_decode_post_increment_and_reglist);
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "../unity/unity.h"
+#include "idn16/memory.h"
+#include "idn16/listing.h"
+#include "idn16/labels.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t memory[MEMORY_SIZE];
+
+void setUp(void) {
+    memory_init(memory);
+    listing_invalidate_all();
+}
+
+void tearDown(void) {
+}
+
+void test_listing_formats_line(void) {
+    memory_write_word(memory, 0x0004, 0xC000, true);  // HLT
+    const char* line = listing_line(memory, 0x0004);
+    TEST_ASSERT_NOT_NULL(strstr(line, "0004  C000"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "HLT"));
+    TEST_ASSERT_NULL(strchr(line, '\n'));
+
+    // Odd addresses give the line of their word
+    TEST_ASSERT_EQUAL_PTR(line, listing_line(memory, 0x0005));
+}
+
+void test_listing_caches_until_written(void) {
+    memory_write_word(memory, 0x0000, 0x4103, true);  // LDI r1, 3
+    listing_line(memory, 0x0000);
+    listing_line(memory, 0x0002);
+    uint32_t formatted = listing_format_count();
+
+    // Asking again formats nothing
+    for (int i = 0; i < 10; i++) {
+        listing_line(memory, 0x0000);
+        listing_line(memory, 0x0002);
+    }
+    TEST_ASSERT_EQUAL_UINT32(formatted, listing_format_count());
+
+    // A written word is formatted again, its neighbour is not
+    memory_write_word(memory, 0x0000, 0xC000, true);
+    TEST_ASSERT_NOT_NULL(strstr(listing_line(memory, 0x0000), "HLT"));
+    listing_line(memory, 0x0002);
+    TEST_ASSERT_EQUAL_UINT32(formatted + 1, listing_format_count());
+}
+
+void test_listing_labels(void) {
+    const char* path = "test_listing.sym";
+    FILE* file = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fprintf(file, "0002 loop\n");
+    fclose(file);
+    TEST_ASSERT_TRUE(labels_load(path));
+    remove(path);
+    listing_invalidate_all();
+
+    TEST_ASSERT_EQUAL_INT(0, strncmp(listing_line(memory, 0x0002), "loop ", 5));
+    TEST_ASSERT_EQUAL_INT(' ', listing_line(memory, 0x0004)[0]);
+}
+
+void test_listing_outside_range(void) {
+    TEST_ASSERT_EQUAL_STRING("", listing_line(memory, VIDEO_RAM_START));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_listing_formats_line);
+    RUN_TEST(test_listing_caches_until_written);
+    RUN_TEST(test_listing_labels);
+    RUN_TEST(test_listing_outside_range);
+    return UNITY_END();
+}
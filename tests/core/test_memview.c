@@ -0,0 +1,77 @@
+#include "../unity/unity.h"
+#include "idn16/memory.h"
+#include "idn16/memview.h"
+
+static uint8_t memory[MEMORY_SIZE];
+
+void setUp(void) {
+    memory_init(memory);
+    memview_reset(memory);
+}
+
+void tearDown(void) {
+}
+
+void test_writes_mark_pages_dirty(void) {
+    TEST_ASSERT_FALSE(memory_page_dirty(RAM_START >> MEMORY_PAGE_SHIFT));
+    memory_write_byte(memory, RAM_START, 0x12, false);
+    TEST_ASSERT_TRUE(memory_page_dirty(RAM_START >> MEMORY_PAGE_SHIFT));
+    TEST_ASSERT_FALSE(memory_page_dirty((RAM_START >> MEMORY_PAGE_SHIFT) + 1));
+
+    // A word across a page boundary marks both pages
+    memory_write_word(memory, RAM_START + MEMORY_PAGE_SIZE * 2 - 1, 0x3456, false);
+    TEST_ASSERT_TRUE(memory_page_dirty((RAM_START >> MEMORY_PAGE_SHIFT) + 1));
+    TEST_ASSERT_TRUE(memory_page_dirty((RAM_START >> MEMORY_PAGE_SHIFT) + 2));
+
+    memory_fill_block(memory, 0x9000, 0xFF, MEMORY_PAGE_SIZE + 1, false);
+    TEST_ASSERT_TRUE(memory_page_dirty(0x90));
+    TEST_ASSERT_TRUE(memory_page_dirty(0x91));
+    TEST_ASSERT_FALSE(memory_page_dirty(0x92));
+
+    memory_clear_dirty_pages();
+    TEST_ASSERT_FALSE(memory_page_dirty(0x90));
+}
+
+void test_update_highlights_changed_bytes(void) {
+    memory_write_word(memory, RAM_START, 0xBEEF, false);
+    // Rewriting a byte with the same value is not a change
+    memory_write_byte(memory, RAM_START + 2, memory[RAM_START + 2], false);
+
+    TEST_ASSERT_EQUAL_INT(2, memview_update(memory));
+    TEST_ASSERT_TRUE(memview_changed(RAM_START));
+    TEST_ASSERT_TRUE(memview_changed(RAM_START + 1));
+    TEST_ASSERT_FALSE(memview_changed(RAM_START + 2));
+
+    // Nothing written: nothing compared or changed
+    TEST_ASSERT_EQUAL_INT(0, memview_update(memory));
+    TEST_ASSERT_TRUE(memview_changed(RAM_START));
+}
+
+void test_highlight_fades(void) {
+    memory_write_byte(memory, RAM_START, 1, false);
+    memview_update(memory);
+    for (int i = 1; i < MEMVIEW_HIGHLIGHT_FRAMES; i++) {
+        memview_update(memory);
+    }
+    TEST_ASSERT_TRUE(memview_changed(RAM_START));
+    memview_update(memory);
+    TEST_ASSERT_FALSE(memview_changed(RAM_START));
+}
+
+void test_changes_outside_dirty_pages_are_not_scanned(void) {
+    // Changed behind memory.c's back: not seen until the page is written through it
+    memory[RAM_START + 5] = 0x77;
+    TEST_ASSERT_EQUAL_INT(0, memview_update(memory));
+    memory_write_byte(memory, RAM_START, 0x01, false);
+    TEST_ASSERT_EQUAL_INT(2, memview_update(memory));
+    TEST_ASSERT_TRUE(memview_changed(RAM_START + 5));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_writes_mark_pages_dirty);
+    RUN_TEST(test_update_highlights_changed_bytes);
+    RUN_TEST(test_highlight_fades);
+    RUN_TEST(test_changes_outside_dirty_pages_are_not_scanned);
+    return UNITY_END();
+}
@@ -0,0 +1,96 @@
+#include "../unity/unity.h"
+#include "idn16/perf.h"
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) {
+    perf_clear();
+    perf_restart(0);
+}
+
+void tearDown(void) {
+    perf_log_close();
+}
+
+void test_perf_frames_close_into_history(void) {
+    perf_restart(1000);
+    perf_add_time(PERF_CPU, 300);
+    perf_add_time(PERF_CPU, 200);
+    perf_add_time(PERF_PRESENT, 50);
+    perf_current()->guest_frames = 2;
+    perf_current()->instructions = 8000;
+    perf_end_frame(5000);
+
+    perf_frame_t frames[4];
+    TEST_ASSERT_EQUAL_INT(1, perf_last(frames, 4));
+    TEST_ASSERT_EQUAL_UINT64(4000, frames[0].host_ns);
+    TEST_ASSERT_EQUAL_UINT64(500, frames[0].phase_ns[PERF_CPU]);
+    TEST_ASSERT_EQUAL_UINT64(50, frames[0].phase_ns[PERF_PRESENT]);
+    TEST_ASSERT_EQUAL_UINT32(2, frames[0].guest_frames);
+    TEST_ASSERT_EQUAL_UINT64(8000, frames[0].instructions);
+
+    // The next frame starts empty where the last one ended
+    TEST_ASSERT_EQUAL_UINT64(0, perf_current()->phase_ns[PERF_CPU]);
+    perf_end_frame(9000);
+    TEST_ASSERT_EQUAL_INT(2, perf_last(frames, 4));
+    TEST_ASSERT_EQUAL_UINT64(4000, frames[1].host_ns);
+    TEST_ASSERT_EQUAL_UINT32(0, frames[1].guest_frames);
+}
+
+void test_perf_restart_drops_open_frame(void) {
+    perf_add_time(PERF_UI, 777);
+    perf_restart(100000);
+    perf_end_frame(104000);
+
+    perf_frame_t frame;
+    TEST_ASSERT_EQUAL_INT(1, perf_last(&frame, 1));
+    TEST_ASSERT_EQUAL_UINT64(4000, frame.host_ns);
+    TEST_ASSERT_EQUAL_UINT64(0, frame.phase_ns[PERF_UI]);
+}
+
+void test_perf_history_keeps_newest_and_sums(void) {
+    for (int i = 0; i < PERF_HISTORY + 10; i++) {
+        perf_current()->syscalls = i;
+        perf_end_frame((uint64_t)(i + 1) * 1000);
+    }
+    static perf_frame_t frames[PERF_HISTORY + 10];
+    TEST_ASSERT_EQUAL_INT(PERF_HISTORY, perf_last(frames, PERF_HISTORY + 10));
+    TEST_ASSERT_EQUAL_UINT32(10, frames[0].syscalls);
+    TEST_ASSERT_EQUAL_UINT32(PERF_HISTORY + 9, frames[PERF_HISTORY - 1].syscalls);
+
+    perf_frame_t sum;
+    TEST_ASSERT_EQUAL_INT(3, perf_sum(3, &sum));
+    TEST_ASSERT_EQUAL_UINT32(3 * (PERF_HISTORY + 8), sum.syscalls);
+    TEST_ASSERT_EQUAL_UINT64(3000, sum.host_ns);
+    TEST_ASSERT_EQUAL_INT(PERF_HISTORY, perf_sum(PERF_HISTORY * 2, &sum));
+}
+
+void test_perf_log(void) {
+    const char* path = "test_perf.csv";
+    TEST_ASSERT_TRUE(perf_log_open(path));
+    perf_add_time(PERF_RASTER, 1200);
+    perf_current()->dirty_cells = 40;
+    perf_current()->audio_queued_bytes = 4096;
+    perf_end_frame(4000);
+    perf_log_close();
+
+    FILE* file = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(file);
+    char line[256];
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), file));
+    TEST_ASSERT_EQUAL_STRING("host_ns,cpu_ns,raster_ns,upload_ns,ui_ns,present_ns,guest_frames,instructions,syscalls,dirty_cells,audio_queued_bytes\n", line);
+    TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), file));
+    TEST_ASSERT_EQUAL_STRING("0,0,1200,0,0,0,0,0,0,40,4096\n", line);
+    TEST_ASSERT_NULL(fgets(line, sizeof(line), file));
+    fclose(file);
+    remove(path);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_perf_frames_close_into_history);
+    RUN_TEST(test_perf_restart_drops_open_frame);
+    RUN_TEST(test_perf_history_keeps_newest_and_sums);
+    RUN_TEST(test_perf_log);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+#include "idn16/plugin.h"
+#include "idn16/syscall_table.h"
+
+static Cpu_t* cpu;
+static const idn16_host_api_t* host;
+
+void setUp(void) {
+    cpu = cpu_init();
+    TEST_ASSERT_NOT_NULL(cpu);
+    host = plugin_host_api();
+}
+
+void tearDown(void) {
+    plugin_unload_all();
+    cpu_destroy(cpu);
+}
+
+// Sums r2 bytes starting at r1 into r1, charging one cycle per byte
+static void sum_bytes(idn16_cpu_t* c, void* userdata) {
+    int* calls = userdata;
+    uint16_t address = host->get_reg(c, 1);
+    uint16_t length = host->get_reg(c, 2);
+    uint8_t buffer[64];
+    uint16_t sum = 0;
+    if (length <= sizeof(buffer) && host->read_block(c, address, buffer, length)) {
+        for (int i = 0; i < length; i++) sum += buffer[i];
+    }
+    host->charge_cycles(c, length);
+    host->set_reg(c, 1, sum);
+    (*calls)++;
+}
+
+// Tries to escape the guest view: write r0, ROM and an out-of-range block
+static void misbehave(idn16_cpu_t* c, void* userdata) {
+    bool* results = userdata;
+    host->set_reg(c, 0, 0x1234);
+    host->set_reg(c, 9, 0x1234);
+    results[0] = host->write_byte(c, USER_ROM_START, 0x42);
+    results[1] = host->write_block(c, 0xFFF0, "0123456789ABCDEFGH", 18);
+    results[2] = host->write_word(c, RAM_START, 0xBEEF);
+}
+
+void test_plugin_syscall_dispatch(void) {
+    int calls = 0;
+    const uint16_t address = 0xF400;
+    TEST_ASSERT_EQUAL_UINT32(IDN16_PLUGIN_API_VERSION, host->api_version);
+    TEST_ASSERT_TRUE(host->register_syscall(address, "SUM_BYTES", 2, 5, sum_bytes, &calls));
+
+    const syscall_info_t* info = syscall_info(address);
+    TEST_ASSERT_NOT_NULL(info);
+    TEST_ASSERT_EQUAL_STRING("SUM_BYTES", info->name);
+    TEST_ASSERT_EQUAL_UINT16(5, info->cycles);
+
+    for (int i = 0; i < 4; i++) {
+        memory_write_byte(cpu->memory, RAM_START + i, 10 + i, false);
+    }
+    cpu->r[1] = RAM_START;
+    cpu->r[2] = 4;
+    uint64_t cycles = cpu->cycles;
+    handle_system_call(address, cpu);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_UINT16(10 + 11 + 12 + 13, cpu->r[1]);
+    // Declared cost plus what the handler charged
+    TEST_ASSERT_EQUAL_UINT64(cycles + 5 + 4, cpu->cycles);
+    TEST_ASSERT_EQUAL_UINT64(1, syscall_stats(address)->calls);
+}
+
+void test_plugin_cannot_take_used_addresses(void) {
+    int calls = 0;
+    // Built-in syscalls and addresses outside the syscall range are rejected
+    TEST_ASSERT_FALSE(host->register_syscall(SYSCALL_PUT_CHAR, "PUT_CHAR", 1, 0, sum_bytes, &calls));
+    TEST_ASSERT_FALSE(host->register_syscall(RAM_START, "RAM", 0, 0, sum_bytes, &calls));
+    TEST_ASSERT_TRUE(host->register_syscall(0xF401, "FIRST", 0, 0, sum_bytes, &calls));
+    TEST_ASSERT_FALSE(host->register_syscall(0xF401, "SECOND", 0, 0, sum_bytes, &calls));
+
+    // Unloading removes plugin syscalls but keeps the built-ins
+    plugin_unload_all();
+    TEST_ASSERT_NULL(syscall_info(0xF401));
+    TEST_ASSERT_NOT_NULL(syscall_info(SYSCALL_PUT_CHAR));
+}
+
+void test_plugin_view_is_checked(void) {
+    bool results[3] = { true, true, false };
+    TEST_ASSERT_TRUE(host->register_syscall(0xF402, "MISBEHAVE", 0, 0, misbehave, results));
+    uint8_t rom_byte = memory_read_byte(cpu->memory, USER_ROM_START);
+    handle_system_call(0xF402, cpu);
+
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[0]);
+    TEST_ASSERT_FALSE(results[0]);
+    TEST_ASSERT_EQUAL_UINT8(rom_byte, memory_read_byte(cpu->memory, USER_ROM_START));
+    TEST_ASSERT_FALSE(results[1]);
+    TEST_ASSERT_TRUE(results[2]);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, memory_read_word(cpu->memory, RAM_START));
+}
+
+void test_plugin_load_failure(void) {
+    TEST_ASSERT_FALSE(plugin_load("/nonexistent/idn16_plugin.so"));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_plugin_syscall_dispatch);
+    RUN_TEST(test_plugin_cannot_take_used_addresses);
+    RUN_TEST(test_plugin_view_is_checked);
+    RUN_TEST(test_plugin_load_failure);
+    return UNITY_END();
+}
@@ -0,0 +1,180 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+#include "idn16/profiler.h"
+#include "idn16/labels.h"
+#include "idn16/syscall_table.h"
+#include "test_programs.h"
+#include <stdio.h>
+#include <string.h>
+
+static Cpu_t* cpu;
+
+void setUp(void) {
+    cpu = cpu_init();
+    TEST_ASSERT_NOT_NULL(cpu);
+    profiler_reset();
+    syscall_stats_reset();
+}
+
+void tearDown(void) {
+    cpu_destroy(cpu);
+}
+
+void test_profiler_counts_per_pc(void) {
+    load_countdown(cpu);
+    run_until_halt(cpu, cpu_cycle_profiled, 1000);
+
+    const profile_t* p = profiler_data();
+    TEST_ASSERT_EQUAL_UINT64(COUNTDOWN_INSTRUCTIONS, p->instructions);
+    TEST_ASSERT_EQUAL_UINT64(cpu->cycles, p->cycles);
+    TEST_ASSERT_EQUAL_UINT64(COUNTDOWN_INSTRUCTIONS, cpu->instructions);
+    TEST_ASSERT_EQUAL_UINT64(1, p->pc_count[0x0000 / 2]);
+    TEST_ASSERT_EQUAL_UINT64(3, p->pc_count[0x0002 / 2]);
+    TEST_ASSERT_EQUAL_UINT64(3, p->pc_count[0x0006 / 2]);
+    TEST_ASSERT_EQUAL_UINT64(1, p->pc_count[0x000A / 2]);
+    TEST_ASSERT_EQUAL_UINT64(3, p->pc_cycles[0x0002 / 2]);
+
+    // The three STWs and the PUSHM are stores to RAM
+    TEST_ASSERT_EQUAL_UINT64(4, p->class_count[INSN_CLASS_ALU]);
+    TEST_ASSERT_EQUAL_UINT64(3, p->class_count[INSN_CLASS_BRANCH]);
+    TEST_ASSERT_EQUAL_UINT64(4, p->class_count[INSN_CLASS_STORE]);
+    TEST_ASSERT_EQUAL_UINT64(1, p->class_count[INSN_CLASS_OTHER]);
+    TEST_ASSERT_EQUAL_UINT64(4, p->region_writes[REGION_RAM]);
+    TEST_ASSERT_EQUAL_UINT64(0, p->region_reads[REGION_RAM]);
+
+    profiler_reset();
+    TEST_ASSERT_EQUAL_UINT64(0, profiler_data()->instructions);
+    TEST_ASSERT_EQUAL_UINT64(0, profiler_data()->pc_count[0x0002 / 2]);
+}
+
+void test_profiler_charges_syscall_cycles_to_caller(void) {
+    const uint16_t program[] = {
+        0xAC00,  // JSR r4
+    };
+    load_program(cpu, program, 1);
+    cpu->r[1] = RAM_START;
+    cpu->r[2] = 0;
+    cpu->r[3] = 16;
+    cpu->r[4] = SYSCALL_MEMSET;
+    cpu_cycle_profiled(cpu);
+
+    const profile_t* p = profiler_data();
+    TEST_ASSERT_EQUAL_UINT64(1, p->class_count[INSN_CLASS_SYSCALL]);
+    TEST_ASSERT_TRUE(cpu->cycles > 1);
+    TEST_ASSERT_EQUAL_UINT64(cpu->cycles, p->pc_cycles[0]);
+    TEST_ASSERT_EQUAL_UINT64(1, syscall_stats(SYSCALL_MEMSET)->calls);
+}
+
+void test_profiler_labels_and_report(void) {
+    const char* path = "test_profiler.sym";
+    FILE* f = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("0002 loop\n0000 start\n0008 done\n", f);
+    fclose(f);
+    TEST_ASSERT_TRUE(labels_load(path));
+    remove(path);
+    TEST_ASSERT_FALSE(labels_load("does_not_exist.sym"));
+
+    uint16_t offset;
+    TEST_ASSERT_EQUAL_STRING("loop", labels_lookup(0x0004, &offset));
+    TEST_ASSERT_EQUAL_UINT16(2, offset);
+    TEST_ASSERT_EQUAL_STRING("start", labels_lookup(0x0000, &offset));
+    TEST_ASSERT_EQUAL_STRING("done", labels_lookup(0x0100, NULL));
+
+    load_countdown(cpu);
+    run_until_halt(cpu, cpu_cycle_profiled, 1000);
+
+    char report[8192] = {0};
+    FILE* out = tmpfile();
+    TEST_ASSERT_NOT_NULL(out);
+    profiler_print_report(out, cpu, 10);
+    rewind(out);
+    fread(report, 1, sizeof(report) - 1, out);
+    fclose(out);
+
+    // The loop body is the hottest label
+    TEST_ASSERT_NOT_NULL(strstr(report, "Profile: 12 instructions"));
+    TEST_ASSERT_NOT_NULL(strstr(report, "loop+0"));
+    const char* labels = strstr(report, "\nlabel ");
+    TEST_ASSERT_NOT_NULL(labels);
+    TEST_ASSERT_EQUAL_INT(0, strncmp(strchr(labels + 1, '\n') + 1, "loop ", 5));
+
+    // Closing the ROM forgets its labels
+    labels_clear();
+    TEST_ASSERT_EQUAL_INT(0, labels_count());
+    TEST_ASSERT_NULL(labels_lookup(0x0004, NULL));
+}
+
+void test_profiler_call_graph(void) {
+    const char* symbols = "test_calls.sym";
+    FILE* f = fopen(symbols, "w");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("0000 main\n0010 helper\n", f);
+    fclose(f);
+    TEST_ASSERT_TRUE(labels_load(symbols));
+    remove(symbols);
+
+    const uint16_t program[] = {
+        0x4410,  // 0x0000: LDI r4, 0x10
+        0xAC00,  // 0x0002: JSR r4
+        0xAC00,  // 0x0004: JSR r4
+        0xC000,  // 0x0006: HLT
+    };
+    const uint16_t helper[] = {
+        0xF883,  // 0x0010: PUSHM ra
+        0xAD00,  // 0x0012: JSR r5 (RANDOM)
+        0xFC83,  // 0x0014: POPM ra
+        0xB000,  // 0x0016: RET
+    };
+    load_program(cpu, program, 4);
+    for (int i = 0; i < 4; i++) {
+        memory_write_word(cpu->memory, 0x0010 + i * 2, helper[i], true);
+    }
+    cpu->r[5] = SYSCALL_RANDOM;
+    run_until_halt(cpu, cpu_cycle_profiled, 1000);
+
+    int count;
+    const call_node_t* nodes = profiler_call_tree(&count);
+    TEST_ASSERT_EQUAL_INT(3, count);
+    profiler_update_inclusive();
+
+    // Root: LDI, two JSRs and HLT
+    TEST_ASSERT_EQUAL_UINT64(4, nodes[0].exclusive);
+    TEST_ASSERT_EQUAL_UINT64(cpu->cycles, nodes[0].inclusive);
+
+    const call_node_t* sub = &nodes[1];
+    TEST_ASSERT_EQUAL_UINT16(0x0010, sub->address);
+    TEST_ASSERT_FALSE(sub->syscall);
+    TEST_ASSERT_EQUAL_UINT64(2, sub->calls);
+    TEST_ASSERT_EQUAL_UINT64(6, sub->exclusive);
+
+    const call_node_t* leaf = &nodes[2];
+    TEST_ASSERT_TRUE(leaf->syscall);
+    TEST_ASSERT_EQUAL_INT(1, leaf->parent);
+    TEST_ASSERT_EQUAL_UINT64(2, leaf->calls);
+    TEST_ASSERT_EQUAL_UINT64(sub->exclusive + leaf->exclusive, sub->inclusive);
+
+    const char* path = "test_calls.folded";
+    TEST_ASSERT_TRUE(profiler_write_collapsed(path));
+    char stacks[256] = {0};
+    f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    fread(stacks, 1, sizeof(stacks) - 1, f);
+    fclose(f);
+    remove(path);
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "main 4\nmain;helper 6\nmain;helper;RANDOM %llu\n",
+             (unsigned long long)leaf->exclusive);
+    TEST_ASSERT_EQUAL_STRING(expected, stacks);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_profiler_counts_per_pc);
+    RUN_TEST(test_profiler_charges_syscall_cycles_to_caller);
+    RUN_TEST(test_profiler_labels_and_report);
+    RUN_TEST(test_profiler_call_graph);
+    return UNITY_END();
+}
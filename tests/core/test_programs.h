@@ -0,0 +1,43 @@
+#ifndef TEST_PROGRAMS_H
+#define TEST_PROGRAMS_H
+
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+
+/*
+ * Guest programs shared by the debugger and instrumentation tests, so each suite only holds
+ * its own assertions.
+ */
+
+// Counts down r1 from 3, storing it at [r2] each time round, then pushes it and halts
+static const uint16_t countdown[] = {
+    0x4103,  // 0x0000: LDI r1, 3
+    0xD900,  // 0x0002: DEC r1
+    0x5140,  // 0x0004: STW r1, [r2+0]
+    0x97FC,  // 0x0006: JNE -4
+    0xF807,  // 0x0008: PUSHM r1
+    0xC000,  // 0x000A: HLT
+};
+#define COUNTDOWN_LENGTH (int)(sizeof(countdown) / sizeof(*countdown))
+#define COUNTDOWN_INSTRUCTIONS 12
+
+static inline void load_program(Cpu_t* cpu, const uint16_t* words, int count) {
+    for (int i = 0; i < count; i++) {
+        memory_write_word(cpu->memory, USER_ROM_START + i * 2, words[i], true);
+    }
+}
+
+// Loads countdown with r2 pointing at the start of RAM
+static inline void load_countdown(Cpu_t* cpu) {
+    load_program(cpu, countdown, COUNTDOWN_LENGTH);
+    cpu->r[2] = RAM_START;
+}
+
+// Steps the CPU with cycle until it halts, giving up after max_steps
+static inline void run_until_halt(Cpu_t* cpu, void (*cycle)(Cpu_t*), int max_steps) {
+    for (int i = 0; i < max_steps && cpu->running; i++) {
+        cycle(cpu);
+    }
+}
+
+#endif // TEST_PROGRAMS_H
@@ -1,6 +1,8 @@
 #include "../unity/unity.h"
 #include "idn16/cpu.h"
 #include "idn16/memory.h"
+#include "idn16/syscall_table.h"
+#include "idn16/timing.h"
 #include <string.h>
 
 static Cpu_t* cpu;
@@ -74,6 +76,299 @@ void test_syscall_put_char_newline(void) {
     TEST_ASSERT_EQUAL_UINT16(6, memory_read_word(cpu->memory, CURSOR_Y_REG));
 }
 
+void test_syscall_scroll_up_moves_ring_offset(void) {
+    // Row 1 becomes the top row after one scroll
+    cpu->r[1] = 0;
+    cpu->r[2] = 1;
+    cpu->r[3] = 'B';
+    syscall_put_char_at(cpu);
+    cpu->r[2] = SCREEN_HEIGHT_TILES - 1;
+    cpu->r[3] = 'Z';
+    syscall_put_char_at(cpu);
+
+    syscall_scroll_up(cpu);
+    TEST_ASSERT_EQUAL_UINT16(1, memory_read_word(cpu->memory, TEXT_SCROLL_Y_REG));
+
+    // Screen position (0, 0) now maps to the cell that held row 1
+    cpu->r[1] = 0;
+    cpu->r[2] = 0;
+    cpu->r[3] = 'C';
+    syscall_put_char_at(cpu);
+    TEST_ASSERT_EQUAL_UINT8('C', memory_read_byte(cpu->memory, CHAR_BUFFER_START + SCREEN_WIDTH_TILES));
+
+    // The new bottom row is the old top row, cleared
+    for (int x = 0; x < SCREEN_WIDTH_TILES; x++) {
+        TEST_ASSERT_EQUAL_UINT8(' ', memory_read_byte(cpu->memory, CHAR_BUFFER_START + x));
+    }
+    // Everything else stays where it was in memory
+    TEST_ASSERT_EQUAL_UINT8('Z', memory_read_byte(cpu->memory, CHAR_BUFFER_START + (SCREEN_HEIGHT_TILES - 1) * SCREEN_WIDTH_TILES));
+
+    // The offset wraps after a full screen of scrolling
+    for (int i = 1; i < SCREEN_HEIGHT_TILES; i++) {
+        syscall_scroll_up(cpu);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, memory_read_word(cpu->memory, TEXT_SCROLL_Y_REG));
+
+    // Clearing the screen resets the offset
+    syscall_scroll_up(cpu);
+    syscall_clear_screen(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, memory_read_word(cpu->memory, TEXT_SCROLL_Y_REG));
+}
+
+void test_syscall_set_sprite_reaches_high_ids(void) {
+    cpu->r[1] = 700;
+    cpu->r[2] = 4;
+    cpu->r[3] = 5;
+    cpu->r[4] = 2;
+    syscall_set_sprite(cpu);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[1]);
+
+    // Sprite 700 must not alias sprite 700 & 0xFF
+    TEST_ASSERT_EQUAL_UINT8(2, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (700 * 3) + 2));
+    TEST_ASSERT_EQUAL_UINT8(0, memory_read_byte(cpu->memory, SPRITE_TABLE_START + ((700 & 0xFF) * 3) + 2));
+}
+
+void test_syscall_update_sprites_applies_valid_records(void) {
+    const uint16_t list = RAM_START + 0x100;
+    const struct { uint16_t id; uint8_t x, y, tile; } records[] = {
+        { 5, 1, 2, 3 },         // Sprite 5 at (1, 2), tile 3
+        { 700, 39, 29, 1 },     // Sprite 700 at (39, 29), tile 1
+        { 1300, 0, 0, 1 },      // Sprite 1300: invalid id
+        { 6, 40, 0, 1 },        // Sprite 6 at x=40: invalid position
+    };
+    // Ids are stored as words, the way the guest writes them with STW
+    for (int i = 0; i < 4; i++) {
+        uint16_t record = list + i * SPRITE_RECORD_SIZE;
+        memory_write_word(cpu->memory, record, records[i].id, false);
+        memory_write_byte(cpu->memory, record + 2, records[i].x, false);
+        memory_write_byte(cpu->memory, record + 3, records[i].y, false);
+        memory_write_byte(cpu->memory, record + 4, records[i].tile, false);
+    }
+
+    cpu->r[1] = list;
+    cpu->r[2] = 4;
+    syscall_update_sprites(cpu);
+    TEST_ASSERT_EQUAL_UINT16(2, cpu->r[1]);
+
+    TEST_ASSERT_EQUAL_UINT8(1, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (5 * 3) + 0));
+    TEST_ASSERT_EQUAL_UINT8(2, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (5 * 3) + 1));
+    TEST_ASSERT_EQUAL_UINT8(3, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (5 * 3) + 2));
+    TEST_ASSERT_EQUAL_UINT8(39, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (700 * 3) + 0));
+    TEST_ASSERT_EQUAL_UINT8(0, memory_read_byte(cpu->memory, SPRITE_TABLE_START + (6 * 3) + 2));
+
+    // A list running off the end of memory is rejected outright
+    cpu->r[1] = 0xFFFE;
+    cpu->r[2] = 1;
+    syscall_update_sprites(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+}
+
+void test_syscall_load_tiles_copies_whole_tiles(void) {
+    const uint16_t src = RAM_START + 0x200;
+    for (int i = 0; i < 2 * 64; i++) {
+        memory_write_byte(cpu->memory, src + i, i % 16, false);
+    }
+
+    cpu->r[1] = src;
+    cpu->r[2] = 3;  // Tiles 3 and 4
+    cpu->r[3] = 2;
+    syscall_load_tiles(cpu);
+    TEST_ASSERT_EQUAL_UINT16(2, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, memory_read_byte(cpu->memory, TILESET_DATA_START + (2 * 64)));
+    TEST_ASSERT_EQUAL_UINT8(15, memory_read_byte(cpu->memory, TILESET_DATA_START + (3 * 64) + 63));
+    // Neighbouring tile untouched (memory_init fills tiles with 17)
+    TEST_ASSERT_EQUAL_UINT8(17, memory_read_byte(cpu->memory, TILESET_DATA_START + (4 * 64)));
+
+    // Runs past the last tile are rejected
+    cpu->r[1] = src;
+    cpu->r[2] = MAX_TILES;
+    cpu->r[3] = 2;
+    syscall_load_tiles(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+}
+
+void test_syscall_load_palette_copies_all_entries(void) {
+    const uint16_t src = RAM_START + 0x300;
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        memory_write_word(cpu->memory, src + (i * 2), 0x1000 + i, false);
+    }
+
+    cpu->r[1] = src;
+    syscall_load_palette(cpu);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[1]);
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        TEST_ASSERT_EQUAL_HEX16(0x1000 + i, memory_read_word(cpu->memory, PALETTE_RAM_START + (i * 2)));
+    }
+}
+
+static void place_sprite(uint16_t id, uint8_t x, uint8_t y) {
+    cpu->r[1] = id;
+    cpu->r[2] = x;
+    cpu->r[3] = y;
+    cpu->r[4] = 1;
+    syscall_set_sprite(cpu);
+}
+
+static void collide(uint16_t a_first, uint16_t a_last, uint16_t b_first, uint16_t b_last,
+                    uint16_t out, uint16_t max_records) {
+    cpu->r[1] = a_first;
+    cpu->r[2] = a_last;
+    cpu->r[3] = b_first;
+    cpu->r[4] = b_last;
+    cpu->r[5] = out;
+    cpu->r[6] = max_records;
+    syscall_collide_sprites(cpu);
+}
+
+void test_syscall_collide_sprites_reports_hits(void) {
+    const uint16_t out = RAM_START + 0x400;
+
+    // Bullets 10-12 against enemies 500-502
+    place_sprite(10, 3, 3);
+    place_sprite(11, 7, 7);
+    place_sprite(12, 9, 9);
+    place_sprite(500, 7, 7);
+    place_sprite(501, 3, 3);
+    place_sprite(502, 20, 20);
+
+    collide(10, 12, 500, 502, out, 16);
+    TEST_ASSERT_EQUAL_UINT16(2, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(10, memory_read_word(cpu->memory, out));
+    TEST_ASSERT_EQUAL_UINT16(501, memory_read_word(cpu->memory, out + 2));
+    TEST_ASSERT_EQUAL_UINT16(11, memory_read_word(cpu->memory, out + 4));
+    TEST_ASSERT_EQUAL_UINT16(500, memory_read_word(cpu->memory, out + 6));
+
+    // Moving the enemy away is picked up from the sprite table write
+    cpu->r[1] = 500;
+    cpu->r[2] = 30;
+    cpu->r[3] = 1;
+    syscall_move_sprite(cpu);
+    collide(10, 12, 500, 502, out, 16);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[1]);
+
+    // A sprite never collides with itself when the ranges overlap
+    collide(12, 12, 0, MAX_SPRITES - 1, out, 16);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+}
+
+void test_syscall_collide_sprites_reports_every_pair(void) {
+    const uint16_t out = RAM_START + 0x400;
+
+    // One bullet over two enemies gets a record for each, lowest enemy first
+    place_sprite(10, 3, 3);
+    place_sprite(502, 3, 3);
+    place_sprite(501, 3, 3);
+    place_sprite(11, 7, 7);
+    place_sprite(500, 7, 7);
+
+    collide(10, 11, 500, 502, out, 16);
+    TEST_ASSERT_EQUAL_UINT16(3, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(10, memory_read_word(cpu->memory, out));
+    TEST_ASSERT_EQUAL_UINT16(501, memory_read_word(cpu->memory, out + 2));
+    TEST_ASSERT_EQUAL_UINT16(10, memory_read_word(cpu->memory, out + 4));
+    TEST_ASSERT_EQUAL_UINT16(502, memory_read_word(cpu->memory, out + 6));
+    TEST_ASSERT_EQUAL_UINT16(11, memory_read_word(cpu->memory, out + 8));
+    TEST_ASSERT_EQUAL_UINT16(500, memory_read_word(cpu->memory, out + 10));
+
+    // Records stop at the caller's capacity
+    memory_write_word(cpu->memory, out + 4, 0xBEEF, false);
+    collide(10, 11, 500, 502, out, 1);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, memory_read_word(cpu->memory, out + 4));
+
+    // A buffer running past the end of memory is rejected
+    collide(10, 11, 500, 502, MEMORY_SIZE - 4, 2);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+}
+
+void test_syscall_timer_follows_refresh_rate(void) {
+    // At 30 Hz each guest frame is 33 ms, not the 16 ms of the default 60 Hz
+    TEST_ASSERT_TRUE(timing_set(CPU_CLOCK_HZ, 30));
+    cpu->r[1] = 1500;
+    syscall_timer_start(cpu);
+    cpu->frame_count += 30;
+    cpu->r[1] = 0;
+    syscall_timer_query(cpu);
+    TEST_ASSERT_EQUAL_UINT16(500, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[2]);
+
+    cpu->frame_count += 15;
+    cpu->r[1] = 0;
+    syscall_timer_query(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[2]);
+    TEST_ASSERT_TRUE(timing_set(CPU_CLOCK_HZ, DISPLAY_REFRESH_HZ));
+}
+
+void test_syscall_block_memory_operations(void) {
+    const uint16_t a = RAM_START + 0x500;
+    const uint16_t b = RAM_START + 0x600;
+    const char text[] = "IDN-16";
+    for (int i = 0; i < (int)sizeof(text); i++) {
+        memory_write_byte(cpu->memory, a + i, text[i], false);
+    }
+
+    // memcpy copies, including overlapping ranges
+    cpu->r[1] = b;
+    cpu->r[2] = a;
+    cpu->r[3] = sizeof(text);
+    uint64_t cycles = cpu->cycles;
+    syscall_memcpy(cpu);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(text), cpu->r[1]);
+    TEST_ASSERT_TRUE(cpu->cycles > cycles);
+    cpu->r[1] = b + 1;
+    cpu->r[2] = b;
+    cpu->r[3] = 3;
+    syscall_memcpy(cpu);
+    TEST_ASSERT_EQUAL_UINT8('I', memory_read_byte(cpu->memory, b + 1));
+    TEST_ASSERT_EQUAL_UINT8('N', memory_read_byte(cpu->memory, b + 3));
+
+    // memcmp reports the sign of the first difference
+    cpu->r[1] = a;
+    cpu->r[2] = b;
+    cpu->r[3] = 2;
+    syscall_memcmp(cpu);
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)-1, cpu->r[1]);  // "ID" < "II"
+    cpu->r[1] = a;
+    cpu->r[2] = b;
+    cpu->r[3] = 1;
+    syscall_memcmp(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+
+    // memchr returns the address of the match
+    cpu->r[1] = a;
+    cpu->r[2] = '-';
+    cpu->r[3] = sizeof(text);
+    syscall_memchr(cpu);
+    TEST_ASSERT_EQUAL_UINT16(a + 3, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, cpu->r[2]);
+
+    // strlen stops at the terminator or the limit
+    cpu->r[1] = a;
+    cpu->r[2] = 100;
+    syscall_strlen(cpu);
+    TEST_ASSERT_EQUAL_UINT16(6, cpu->r[1]);
+    cpu->r[1] = a;
+    cpu->r[2] = 4;
+    syscall_strlen(cpu);
+    TEST_ASSERT_EQUAL_UINT16(4, cpu->r[1]);
+
+    // memset fills, and refuses privileged regions without writing anything
+    cpu->r[1] = a;
+    cpu->r[2] = 0xAA;
+    cpu->r[3] = 4;
+    syscall_memset(cpu);
+    TEST_ASSERT_EQUAL_UINT16(4, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT8(0xAA, memory_read_byte(cpu->memory, a + 3));
+    TEST_ASSERT_EQUAL_UINT8('1', memory_read_byte(cpu->memory, a + 4));
+    cpu->r[1] = USER_ROM_START;
+    cpu->r[2] = 0xAA;
+    cpu->r[3] = 4;
+    syscall_memset(cpu);
+    TEST_ASSERT_EQUAL_UINT16(0, cpu->r[1]);
+    TEST_ASSERT_NOT_EQUAL(0xAA, memory_read_byte(cpu->memory, USER_ROM_START));
+}
+
 void test_syscall_play_tone_channel(void) {
     // Test channel 0
     cpu->r[1] = 0;      // Channel 0
@@ -205,12 +500,62 @@ void test_syscall_get_input(void) {
     TEST_ASSERT_EQUAL_UINT16(0x55, cpu->r[1]);
 }
 
+void test_syscall_table_dispatch(void) {
+    // Metadata for a few known entries
+    const syscall_info_t* info = syscall_info(SYSCALL_PLAY_TONE_CHANNEL);
+    TEST_ASSERT_NOT_NULL(info);
+    TEST_ASSERT_EQUAL_STRING("PLAY_TONE_CHANNEL", info->name);
+    TEST_ASSERT_EQUAL_UINT8(4, info->argc);
+    TEST_ASSERT_TRUE(info->flags & SYSCALL_TOUCHES_AUDIO);
+    TEST_ASSERT_TRUE(syscall_info(SYSCALL_SET_SPRITE)->flags & SYSCALL_TOUCHES_VIDEO);
+    TEST_ASSERT_EQUAL_UINT16(BLOCK_SYSCALL_BASE_CYCLES, syscall_info(SYSCALL_MEMSET)->cycles);
+    for (uint16_t address = SYSCALL_CLEAR_SCREEN; address <= SYSCALL_STRLEN; address++) {
+        TEST_ASSERT_NOT_NULL(syscall_info(address));
+    }
+    TEST_ASSERT_NULL(syscall_info(SYSCALL_STRLEN + 1));
+    TEST_ASSERT_NULL(syscall_info(0x1234));
+
+    // Dispatch counts calls and charges base plus per-byte cycles
+    syscall_stats_reset();
+    cpu->r[1] = RAM_START + 0x700;
+    cpu->r[2] = 0xAA;
+    cpu->r[3] = 16;
+    uint64_t cycles = cpu->cycles;
+    handle_system_call(SYSCALL_MEMSET, cpu);
+    TEST_ASSERT_EQUAL_UINT16(16, cpu->r[1]);
+    TEST_ASSERT_EQUAL_UINT64(cycles + BLOCK_SYSCALL_BASE_CYCLES + 16 / BLOCK_SYSCALL_BYTES_PER_CYCLE, cpu->cycles);
+    handle_system_call(SYSCALL_RANDOM, cpu);
+    handle_system_call(SYSCALL_RANDOM, cpu);
+
+    const syscall_stats_t* stats = syscall_stats(SYSCALL_MEMSET);
+    TEST_ASSERT_EQUAL_UINT64(1, stats->calls);
+    TEST_ASSERT_EQUAL_UINT64(BLOCK_SYSCALL_BASE_CYCLES + 16 / BLOCK_SYSCALL_BYTES_PER_CYCLE, stats->guest_cycles);
+    TEST_ASSERT_EQUAL_UINT64(2, syscall_stats(SYSCALL_RANDOM)->calls);
+    TEST_ASSERT_EQUAL_UINT64(0, syscall_stats(SYSCALL_PUT_CHAR)->calls);
+
+    // Unknown addresses are ignored and not counted
+    handle_system_call(SYSCALL_STRLEN + 1, cpu);
+    TEST_ASSERT_EQUAL_UINT64(0, syscall_stats(SYSCALL_STRLEN + 1)->calls);
+
+    syscall_stats_reset();
+    TEST_ASSERT_EQUAL_UINT64(0, syscall_stats(SYSCALL_MEMSET)->calls);
+}
+
 int main(void) {
     UNITY_BEGIN();
     
     RUN_TEST(test_syscall_clear_screen);
     RUN_TEST(test_syscall_put_char);
     RUN_TEST(test_syscall_put_char_newline);
+    RUN_TEST(test_syscall_scroll_up_moves_ring_offset);
+    RUN_TEST(test_syscall_set_sprite_reaches_high_ids);
+    RUN_TEST(test_syscall_update_sprites_applies_valid_records);
+    RUN_TEST(test_syscall_load_tiles_copies_whole_tiles);
+    RUN_TEST(test_syscall_load_palette_copies_all_entries);
+    RUN_TEST(test_syscall_collide_sprites_reports_hits);
+    RUN_TEST(test_syscall_collide_sprites_reports_every_pair);
+    RUN_TEST(test_syscall_timer_follows_refresh_rate);
+    RUN_TEST(test_syscall_block_memory_operations);
     RUN_TEST(test_syscall_play_tone_channel);
     RUN_TEST(test_syscall_play_tone_channel_invalid);
     RUN_TEST(test_syscall_stop_channel);
@@ -221,6 +566,7 @@ int main(void) {
     RUN_TEST(test_syscall_divide);
     RUN_TEST(test_syscall_divide_by_zero);
     RUN_TEST(test_syscall_get_input);
+    RUN_TEST(test_syscall_table_dispatch);
     
     return UNITY_END();
 }
\ No newline at end of file
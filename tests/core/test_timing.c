@@ -0,0 +1,88 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/timing.h"
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(timing_set(CPU_CLOCK_HZ, DISPLAY_REFRESH_HZ));
+}
+
+void tearDown(void) {
+}
+
+void test_timing_defaults_and_set(void) {
+    TEST_ASSERT_EQUAL_UINT32(CPU_CLOCK_HZ / DISPLAY_REFRESH_HZ, timing_cycles_per_frame());
+
+    TEST_ASSERT_TRUE(timing_set(250000, 60));
+    TEST_ASSERT_EQUAL_UINT32(250000, timing_clock_hz());
+    TEST_ASSERT_EQUAL_UINT32(60, timing_refresh_hz());
+    TEST_ASSERT_EQUAL_UINT32(4166, timing_cycles_per_frame());
+    TEST_ASSERT_EQUAL_UINT64(16666666, timing_frame_ns());
+
+    // Out of range settings change nothing
+    TEST_ASSERT_FALSE(timing_set(MIN_CLOCK_HZ - 1, 60));
+    TEST_ASSERT_FALSE(timing_set(250000, 0));
+    TEST_ASSERT_FALSE(timing_set(MAX_CLOCK_HZ + 1, 60));
+    TEST_ASSERT_FALSE(timing_set(1000, MAX_REFRESH_HZ + 1));
+    TEST_ASSERT_EQUAL_UINT32(250000, timing_clock_hz());
+    TEST_ASSERT_EQUAL_UINT32(60, timing_refresh_hz());
+}
+
+void test_timing_parse_hz(void) {
+    uint32_t hz = 0;
+    TEST_ASSERT_TRUE(timing_parse_hz("250000", &hz));
+    TEST_ASSERT_EQUAL_UINT32(250000, hz);
+    TEST_ASSERT_TRUE(timing_parse_hz("1.5MHz", &hz));
+    TEST_ASSERT_EQUAL_UINT32(1500000, hz);
+    TEST_ASSERT_TRUE(timing_parse_hz("500khz", &hz));
+    TEST_ASSERT_EQUAL_UINT32(500000, hz);
+    TEST_ASSERT_TRUE(timing_parse_hz("60Hz", &hz));
+    TEST_ASSERT_EQUAL_UINT32(60, hz);
+
+    TEST_ASSERT_FALSE(timing_parse_hz("", &hz));
+    TEST_ASSERT_FALSE(timing_parse_hz("fast", &hz));
+    TEST_ASSERT_FALSE(timing_parse_hz("60 Hz", &hz));
+    TEST_ASSERT_FALSE(timing_parse_hz("0", &hz));
+    TEST_ASSERT_FALSE(timing_parse_hz("-60", &hz));
+}
+
+void test_pacer_does_not_drift(void) {
+    // 240 Hz does not divide a second into whole nanoseconds
+    pacer_t pacer;
+    pacer_start(&pacer, 240, 4, 1000);
+    TEST_ASSERT_EQUAL_UINT32(1, pacer_due(&pacer, 1000));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer_due(&pacer, 1000 + 4166665));
+    TEST_ASSERT_EQUAL_UINT64(1000 + 4166666, pacer_next_ns(&pacer));
+
+    // Waking late on every tick still gives exactly 240 ticks a second
+    uint32_t ticks = 1;
+    for (uint64_t now = 1000; now < 1000 + 10 * NS_PER_SECOND; ) {
+        now = pacer_next_ns(&pacer) + 700000;
+        if (now >= 1000 + 10 * NS_PER_SECOND) break;
+        ticks += pacer_due(&pacer, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2400, ticks);
+    TEST_ASSERT_EQUAL_UINT64(1000 + 10 * NS_PER_SECOND, pacer_next_ns(&pacer));
+}
+
+void test_pacer_catches_up_then_restarts(void) {
+    pacer_t pacer;
+    pacer_start(&pacer, 100, 4, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, pacer_due(&pacer, 0));
+
+    // A short hiccup is made up
+    TEST_ASSERT_EQUAL_UINT32(3, pacer_due(&pacer, 30000000));
+    TEST_ASSERT_EQUAL_UINT64(40000000, pacer_next_ns(&pacer));
+
+    // A long stall restarts the grid instead of running a burst of ticks
+    TEST_ASSERT_EQUAL_UINT32(1, pacer_due(&pacer, 2 * NS_PER_SECOND + 5));
+    TEST_ASSERT_EQUAL_UINT64(2 * NS_PER_SECOND + 5 + 10000000, pacer_next_ns(&pacer));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_timing_defaults_and_set);
+    RUN_TEST(test_timing_parse_hz);
+    RUN_TEST(test_pacer_does_not_drift);
+    RUN_TEST(test_pacer_catches_up_then_restarts);
+    return UNITY_END();
+}
@@ -0,0 +1,173 @@
+#include "../unity/unity.h"
+#include "idn16/cpu.h"
+#include "idn16/memory.h"
+#include "idn16/trace.h"
+#include "test_programs.h"
+#include <stdio.h>
+#include <string.h>
+
+static Cpu_t* cpu;
+
+void setUp(void) {
+    cpu = cpu_init();
+    TEST_ASSERT_NOT_NULL(cpu);
+    trace_clear();
+}
+
+void tearDown(void) {
+    trace_stream_close();
+    cpu_destroy(cpu);
+}
+
+static void run_countdown(void) {
+    load_countdown(cpu);
+    run_until_halt(cpu, cpu_cycle, 100);
+}
+
+void test_trace_records_register_changes(void) {
+    run_countdown();
+
+    trace_record_t records[16];
+    int count = trace_last(records, 16);
+    TEST_ASSERT_EQUAL_INT(COUNTDOWN_INSTRUCTIONS, count);
+
+    // LDI r1, 3
+    TEST_ASSERT_EQUAL_HEX16(0x0000, records[0].pc);
+    TEST_ASSERT_EQUAL_HEX16(0x4103, records[0].instruction);
+    TEST_ASSERT_EQUAL_HEX8(1 << 1, records[0].changed);
+    TEST_ASSERT_EQUAL_HEX16(3, records[0].values[0]);
+
+    // Last DEC r1 reaches zero
+    TEST_ASSERT_EQUAL_HEX16(0x0002, records[7].pc);
+    TEST_ASSERT_EQUAL_HEX16(0, records[7].values[0]);
+    TEST_ASSERT_TRUE(records[7].flags & TRACE_FLAG_Z);
+
+    // STW changes no register
+    TEST_ASSERT_EQUAL_HEX16(0x0004, records[8].pc);
+    TEST_ASSERT_EQUAL_HEX8(0, records[8].changed);
+
+    // PUSHM changes only sp
+    TEST_ASSERT_EQUAL_HEX16(0x0008, records[10].pc);
+    TEST_ASSERT_EQUAL_HEX8(1 << 6, records[10].changed);
+    TEST_ASSERT_EQUAL_HEX16(RAM_END + 1 - 2, records[10].values[0]);
+
+    // Asking for fewer gives the newest ones
+    TEST_ASSERT_EQUAL_INT(1, trace_last(records, 1));
+    TEST_ASSERT_EQUAL_HEX16(0xC000, records[0].instruction);
+
+    char line[TRACE_LINE_LENGTH];
+    trace_format(&records[0], line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "0x000A"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "HLT"));
+}
+
+void test_trace_keeps_every_changed_register(void) {
+    const uint16_t program[] = {
+        0x4101, 0x4202, 0x4303, 0x4404, 0x4505,  // LDI r1..r5, 1..5
+        0xF87F,                                  // PUSHM r1, r2, r3, r4, r5
+        0x4100, 0x4200, 0x4300, 0x4400, 0x4500,  // LDI r1..r5, 0
+        0xFC7F,                                  // POPM r1, r2, r3, r4, r5
+        0xC000,                                  // HLT
+    };
+    load_program(cpu, program, sizeof(program) / sizeof(*program));
+    run_until_halt(cpu, cpu_cycle, 100);
+
+    // POPM restores five registers and sp, and the record holds all six values
+    trace_record_t records[2];
+    TEST_ASSERT_EQUAL_INT(2, trace_last(records, 2));
+    const trace_record_t* popm = &records[0];
+    TEST_ASSERT_EQUAL_HEX16(0xFC7F, popm->instruction);
+    TEST_ASSERT_EQUAL_HEX8(0x7E, popm->changed);
+    for (int r = 1; r <= 5; r++) {
+        TEST_ASSERT_EQUAL_HEX16(r, popm->values[r - 1]);
+    }
+    TEST_ASSERT_EQUAL_HEX16(RAM_END + 1, popm->values[5]);
+
+    char line[TRACE_LINE_LENGTH];
+    trace_format(popm, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "r1=0001 r2=0002 r3=0003 r4=0004 r5=0005 r6="));
+
+    // All of them survive the file encoding
+    trace_record_t prev = {0}, decoded;
+    uint8_t bytes[TRACE_RECORD_MAX_BYTES];
+    int length = trace_encode(popm, &prev, bytes);
+    FILE* file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    fwrite(bytes, 1, length, file);
+    rewind(file);
+    memset(&prev, 0, sizeof(prev));
+    TEST_ASSERT_TRUE(trace_read_record(file, &prev, &decoded));
+    fclose(file);
+    TEST_ASSERT_EQUAL_HEX8(popm->changed, decoded.changed);
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(popm->values, decoded.values, 6);
+}
+
+void test_trace_ring_keeps_newest(void) {
+    // JMP 0 loops on itself
+    memory_write_word(cpu->memory, USER_ROM_START, 0x8000, true);
+    for (int i = 0; i < TRACE_RING_SIZE + 10; i++) {
+        cpu_cycle(cpu);
+    }
+    static trace_record_t records[TRACE_RING_SIZE + 10];
+    TEST_ASSERT_EQUAL_INT(TRACE_RING_SIZE, trace_last(records, TRACE_RING_SIZE + 10));
+    TEST_ASSERT_EQUAL_HEX8(0, records[0].changed);
+
+    trace_clear();
+    TEST_ASSERT_EQUAL_INT(0, trace_last(records, 1));
+}
+
+void test_trace_stream_round_trip(void) {
+    const char* path = "test_trace.trace";
+    TEST_ASSERT_TRUE(trace_stream_open(path));
+    run_countdown();
+    trace_stream_close();
+
+    trace_record_t expected[16];
+    int count = trace_last(expected, 16);
+
+    FILE* file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_TRUE(trace_read_header(file));
+    trace_record_t prev = {0};
+    trace_record_t record;
+    int read = 0;
+    while (trace_read_record(file, &prev, &record)) {
+        TEST_ASSERT_TRUE(read < count);
+        TEST_ASSERT_EQUAL_HEX16(expected[read].pc, record.pc);
+        TEST_ASSERT_EQUAL_HEX16(expected[read].instruction, record.instruction);
+        TEST_ASSERT_EQUAL_HEX8(expected[read].changed, record.changed);
+        TEST_ASSERT_EQUAL_HEX8(expected[read].flags, record.flags);
+        if (record.changed) TEST_ASSERT_EQUAL_HEX16(expected[read].values[0], record.values[0]);
+        read++;
+    }
+    TEST_ASSERT_EQUAL_INT(count, read);
+
+    // Sequential PCs and unchanged flags are left out
+    long size = ftell(file);
+    fclose(file);
+    remove(path);
+    TEST_ASSERT_TRUE(size - TRACE_MAGIC_LENGTH - 1 < count * (long)sizeof(trace_record_t));
+}
+
+void test_trace_kept_on_fault(void) {
+    run_countdown();
+    cpu->running = true;
+    cpu->pc = RAM_END + 2;
+    cpu_cycle(cpu);
+    TEST_ASSERT_FALSE(cpu->running);
+
+    // The faulting fetch is not recorded; the trace still ends with the HLT
+    trace_record_t records[1];
+    TEST_ASSERT_EQUAL_INT(1, trace_last(records, 1));
+    TEST_ASSERT_EQUAL_HEX16(0x000A, records[0].pc);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_trace_records_register_changes);
+    RUN_TEST(test_trace_keeps_every_changed_register);
+    RUN_TEST(test_trace_ring_keeps_newest);
+    RUN_TEST(test_trace_stream_round_trip);
+    RUN_TEST(test_trace_kept_on_fault);
+    return UNITY_END();
+}
@@ -0,0 +1,235 @@
+#include "../unity/unity.h"
+#include "idn16/memory.h"
+#include "idn16/video.h"
+#include <string.h>
+
+static uint8_t test_memory[MEMORY_SIZE];
+
+void setUp(void) {
+    memory_init(test_memory);
+}
+
+void tearDown(void) {
+}
+
+void test_palette_write_changes_palette_generation(void) {
+    uint32_t before = video_palette_generation();
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, PALETTE_RAM_START + 4, 0x1234, false));
+    TEST_ASSERT_NOT_EQUAL(before, video_palette_generation());
+}
+
+void test_tileset_write_changes_only_that_tile(void) {
+    uint32_t tile0 = video_tile_generation(0);
+    uint32_t tile1 = video_tile_generation(1);
+
+    // Second byte row of tile slot 1
+    TEST_ASSERT_TRUE(memory_write_byte(test_memory, TILESET_DATA_START + 64 + 8, 3, false));
+
+    TEST_ASSERT_EQUAL_UINT32(tile0, video_tile_generation(0));
+    TEST_ASSERT_NOT_EQUAL(tile1, video_tile_generation(1));
+}
+
+void test_non_video_write_changes_nothing(void) {
+    uint32_t palette = video_palette_generation();
+    uint32_t tile = video_tile_generation(0);
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, RAM_START, 0xBEEF, false));
+    TEST_ASSERT_EQUAL_UINT32(palette, video_palette_generation());
+    TEST_ASSERT_EQUAL_UINT32(tile, video_tile_generation(0));
+}
+
+void test_memory_init_invalidates_everything(void) {
+    uint32_t palette = video_palette_generation();
+    uint32_t tile = video_tile_generation(MAX_TILES - 1);
+    memory_init(test_memory);
+    TEST_ASSERT_NOT_EQUAL(palette, video_palette_generation());
+    TEST_ASSERT_NOT_EQUAL(tile, video_tile_generation(MAX_TILES - 1));
+}
+
+void test_sprite_table_writes_update_active_index(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, video_active_sprite_count());
+    TEST_ASSERT_EQUAL_UINT16(MAX_SPRITES, video_next_active_sprite(0));
+
+    // Unprivileged byte store (as STB would do) to the tile_id of sprite 700
+    TEST_ASSERT_TRUE(memory_write_byte(test_memory, SPRITE_TABLE_START + (700 * 3) + 2, 5, false));
+    TEST_ASSERT_TRUE(video_sprite_active(700));
+    TEST_ASSERT_EQUAL_UINT16(1, video_active_sprite_count());
+
+    // Writing x/y alone does not activate a sprite
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, SPRITE_TABLE_START + (3 * 3), 0x0404, false));
+    TEST_ASSERT_FALSE(video_sprite_active(3));
+
+    TEST_ASSERT_TRUE(memory_write_byte(test_memory, SPRITE_TABLE_START + (700 * 3) + 2, 0, false));
+    TEST_ASSERT_FALSE(video_sprite_active(700));
+    TEST_ASSERT_EQUAL_UINT16(0, video_active_sprite_count());
+}
+
+void test_active_sprites_iterate_in_table_order(void) {
+    uint16_t ids[] = {2, 63, 64, 130, MAX_SPRITES - 1};
+    for (int i = 4; i >= 0; i--) {
+        memory_write_byte(test_memory, SPRITE_TABLE_START + (ids[i] * 3) + 2, 1, true);
+    }
+
+    int n = 0;
+    for (uint16_t id = video_next_active_sprite(0); id < MAX_SPRITES; id = video_next_active_sprite(id + 1)) {
+        TEST_ASSERT_EQUAL_UINT16(ids[n], id);
+        n++;
+    }
+    TEST_ASSERT_EQUAL_INT(5, n);
+    TEST_ASSERT_EQUAL_UINT16(64, video_next_active_sprite(64));
+    TEST_ASSERT_EQUAL_UINT16(130, video_next_active_sprite(65));
+}
+
+void test_palette_lut_follows_palette_writes(void) {
+    // memory_init loads the default palette into the lookup tables
+    TEST_ASSERT_EQUAL_HEX16(memory_read_word(test_memory, PALETTE_RAM_START + 2), video_palette_rgb565()[1]);
+
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, PALETTE_RAM_START + (5 * 2), 0xF800, false));
+    TEST_ASSERT_EQUAL_HEX16(0xF800, video_palette_rgb565()[5]);
+    TEST_ASSERT_EQUAL_HEX32(0xFFFF0000, video_palette_xrgb8888()[5]);
+
+    // A single byte write updates the entry it belongs to
+    TEST_ASSERT_TRUE(memory_write_byte(test_memory, PALETTE_RAM_START + (5 * 2), 0x1F, false));
+    TEST_ASSERT_EQUAL_HEX16(memory_read_word(test_memory, PALETTE_RAM_START + (5 * 2)), video_palette_rgb565()[5]);
+}
+
+void test_rgb565_to_xrgb8888_expands_full_range(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xFF000000, video_rgb565_to_xrgb8888(0x0000));
+    TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, video_rgb565_to_xrgb8888(0xFFFF));
+    TEST_ASSERT_EQUAL_HEX32(0xFF00FF00, video_rgb565_to_xrgb8888(0x07E0));
+    TEST_ASSERT_EQUAL_HEX32(0xFF0000FF, video_rgb565_to_xrgb8888(0x001F));
+}
+
+void test_text_colors_follow_registers(void) {
+    uint16_t fg, bg;
+    video_text_colors(&fg, &bg);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, fg);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, bg);
+
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, TEXT_FG_COLOR_REG, 0x07E0, true));
+    TEST_ASSERT_TRUE(memory_write_word(test_memory, TEXT_BG_COLOR_REG, 0x001F, true));
+    video_text_colors(&fg, &bg);
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, fg);
+    TEST_ASSERT_EQUAL_HEX16(0x001F, bg);
+}
+
+void test_snapshot_is_independent_of_later_writes(void) {
+    memory_write_word(test_memory, PALETTE_RAM_START + (3 * 2), 0x1234, true);
+    memory_write_byte(test_memory, SPRITE_TABLE_START + (10 * 3) + 2, 4, true);
+
+    video_snapshot_t snapshot;
+    video_state_snapshot(&snapshot);
+
+    memory_write_word(test_memory, PALETTE_RAM_START + (3 * 2), 0x4321, true);
+    memory_write_byte(test_memory, SPRITE_TABLE_START + (10 * 3) + 2, 0, true);
+    memory_write_byte(test_memory, SPRITE_TABLE_START + (20 * 3) + 2, 4, true);
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, snapshot.palette_rgb565[3]);
+    TEST_ASSERT_NOT_EQUAL(snapshot.palette_generation, video_palette_generation());
+    TEST_ASSERT_EQUAL_UINT16(10, video_snapshot_next_active_sprite(&snapshot, 0));
+    TEST_ASSERT_EQUAL_UINT16(MAX_SPRITES, video_snapshot_next_active_sprite(&snapshot, 11));
+    TEST_ASSERT_EQUAL_UINT16(20, video_next_active_sprite(0));
+
+    // Default text colors are resolved in the snapshot
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, snapshot.text_fg_color);
+}
+
+void test_block_write_refreshes_state_once_per_range(void) {
+    uint32_t tile0 = video_tile_generation(0);
+    uint32_t tile2 = video_tile_generation(2);
+    uint8_t data[128];
+    memset(data, 4, sizeof(data));
+
+    // Tiles in slots 0 and 1, plus nothing else
+    TEST_ASSERT_TRUE(memory_write_block(test_memory, TILESET_DATA_START, data, 128, true));
+    TEST_ASSERT_EQUAL_UINT32(tile0 + 1, video_tile_generation(0));
+    TEST_ASSERT_EQUAL_UINT32(tile2, video_tile_generation(2));
+
+    // Spanning the sprite table activates every sprite whose tile byte was written
+    TEST_ASSERT_TRUE(memory_write_block(test_memory, SPRITE_TABLE_START + 3, data, 6, true));
+    TEST_ASSERT_EQUAL_UINT16(2, video_active_sprite_count());
+    TEST_ASSERT_TRUE(video_sprite_active(1));
+    TEST_ASSERT_TRUE(video_sprite_active(2));
+
+    TEST_ASSERT_FALSE(memory_write_block(test_memory, 0xFFF0, data, 32, true));
+}
+
+static void set_background(uint16_t control, uint16_t address, uint16_t width, uint16_t height,
+                           uint16_t scroll_x, uint16_t scroll_y) {
+    memory_write_word(test_memory, BG_CONTROL_REG, control, true);
+    memory_write_word(test_memory, BG_MAP_ADDR_REG, address, true);
+    memory_write_word(test_memory, BG_MAP_WIDTH_REG, width, true);
+    memory_write_word(test_memory, BG_MAP_HEIGHT_REG, height, true);
+    memory_write_word(test_memory, BG_SCROLL_X_REG, scroll_x, true);
+    memory_write_word(test_memory, BG_SCROLL_Y_REG, scroll_y, true);
+}
+
+void test_background_rejects_disabled_and_invalid_maps(void) {
+    video_background_t bg;
+    set_background(0, RAM_START, 4, 2, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+
+    set_background(BG_ENABLE, RAM_START, 4, 2, 3, 5);
+    TEST_ASSERT_TRUE(video_background_read(test_memory, &bg));
+    TEST_ASSERT_EQUAL_HEX16(RAM_START, bg.map_address);
+    TEST_ASSERT_EQUAL_UINT16(4, bg.map_width);
+    TEST_ASSERT_EQUAL_UINT16(2, bg.map_height);
+    TEST_ASSERT_EQUAL_UINT16(3, bg.scroll_x);
+    TEST_ASSERT_EQUAL_UINT16(5, bg.scroll_y);
+
+    // Sizes outside 1..BG_MAP_MAX_SIZE
+    set_background(BG_ENABLE, RAM_START, 0, 2, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+    set_background(BG_ENABLE, RAM_START, 4, 0, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+    set_background(BG_ENABLE, RAM_START, BG_MAP_MAX_SIZE + 1, 2, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+    set_background(BG_ENABLE, RAM_START, 4, BG_MAP_MAX_SIZE + 1, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+
+    // A largest map ending exactly at the end of memory is drawn, one byte further is not
+    set_background(BG_ENABLE, MEMORY_SIZE - BG_MAP_MAX_SIZE * BG_MAP_MAX_SIZE, BG_MAP_MAX_SIZE, BG_MAP_MAX_SIZE, 0, 0);
+    TEST_ASSERT_TRUE(video_background_read(test_memory, &bg));
+    set_background(BG_ENABLE, MEMORY_SIZE - BG_MAP_MAX_SIZE * BG_MAP_MAX_SIZE + 1, BG_MAP_MAX_SIZE, BG_MAP_MAX_SIZE, 0, 0);
+    TEST_ASSERT_FALSE(video_background_read(test_memory, &bg));
+}
+
+void test_background_scroll_wraps_around_the_map(void) {
+    // 4x2 tiles is 32x16 pixels; scroll offsets at or past the map size wrap into it
+    video_background_t bg;
+    set_background(BG_ENABLE, RAM_START, 4, 2, 32 + 6, 16);
+    TEST_ASSERT_TRUE(video_background_read(test_memory, &bg));
+    TEST_ASSERT_EQUAL_UINT16(6, bg.scroll_x);
+    TEST_ASSERT_EQUAL_UINT16(0, bg.scroll_y);
+
+    TEST_ASSERT_EQUAL_UINT16(6, video_background_wrap(0, bg.scroll_x, bg.map_width));
+    TEST_ASSERT_EQUAL_UINT16(31, video_background_wrap(25, bg.scroll_x, bg.map_width));
+    TEST_ASSERT_EQUAL_UINT16(0, video_background_wrap(26, bg.scroll_x, bg.map_width));
+    TEST_ASSERT_EQUAL_UINT16(5, video_background_wrap(319, bg.scroll_x, bg.map_width));
+    TEST_ASSERT_EQUAL_UINT16(15, video_background_wrap(239, bg.scroll_y, bg.map_height));
+
+    // The largest scroll on the largest map stays inside it
+    set_background(BG_ENABLE, RAM_START, BG_MAP_MAX_SIZE, 1, 0xFFFF, 0xFFFF);
+    TEST_ASSERT_TRUE(video_background_read(test_memory, &bg));
+    TEST_ASSERT_EQUAL_UINT16(BG_MAP_MAX_SIZE * TILE_SIZE - 1, bg.scroll_x);
+    TEST_ASSERT_EQUAL_UINT16(TILE_SIZE - 1, bg.scroll_y);
+    TEST_ASSERT_EQUAL_UINT16(0, video_background_wrap(1, bg.scroll_x, bg.map_width));
+    TEST_ASSERT_EQUAL_UINT16(0, video_background_wrap(1, bg.scroll_y, bg.map_height));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_palette_write_changes_palette_generation);
+    RUN_TEST(test_tileset_write_changes_only_that_tile);
+    RUN_TEST(test_non_video_write_changes_nothing);
+    RUN_TEST(test_memory_init_invalidates_everything);
+    RUN_TEST(test_sprite_table_writes_update_active_index);
+    RUN_TEST(test_active_sprites_iterate_in_table_order);
+    RUN_TEST(test_palette_lut_follows_palette_writes);
+    RUN_TEST(test_rgb565_to_xrgb8888_expands_full_range);
+    RUN_TEST(test_text_colors_follow_registers);
+    RUN_TEST(test_snapshot_is_independent_of_later_writes);
+    RUN_TEST(test_block_write_refreshes_state_once_per_range);
+    RUN_TEST(test_background_rejects_disabled_and_invalid_maps);
+    RUN_TEST(test_background_scroll_wraps_around_the_map);
+    return UNITY_END();
+}
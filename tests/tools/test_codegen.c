@@ -66,10 +66,55 @@ void test_symbol_resolution_integration(void) {
     unlink(temp_filename);
 }
 
+void test_reglist_encoding(void) {
+    reset_codegen();
+    emit_reglist_format(0, 0, (1 << 1) | (1 << 2) | (1 << 7), -1);  // PUSHM r1, r2, ra
+    emit_reglist_format(2, 1, (1 << 1) | (1 << 2) | (1 << 7), -1);  // POPM r1, r2, ra
+
+    char temp_filename[] = "/tmp/test_codegen_reglist_XXXXXX";
+    int fd = mkstemp(temp_filename);
+    close(fd);
+    finalize_output(temp_filename);
+
+    FILE* f = fopen(temp_filename, "rb");
+    TEST_ASSERT_NOT_NULL(f);
+    uint16_t words[2] = {0};
+    TEST_ASSERT_EQUAL(2, fread(words, sizeof(uint16_t), 2, f));
+    TEST_ASSERT_EQUAL_HEX16((0b11111 << 11) | (0b100011 << 2) | 0b11, words[0]);
+    TEST_ASSERT_EQUAL_HEX16((0b11111 << 11) | (1 << 10) | (0b100011 << 2) | 0b11, words[1]);
+
+    fclose(f);
+    unlink(temp_filename);
+}
+
+void test_line_map(void) {
+    reset_codegen();
+    emit_reg_format(0, 0, 1, 2, 3, 0);  // ADD r1, r2, r3
+    emit_push_pseudo(2, 1);              // PUSH r1, two words
+    map_source_line(0, 2, 3);
+    map_source_line(2, 6, 5);
+
+    char temp_filename[] = "/tmp/test_codegen_lines_XXXXXX";
+    int fd = mkstemp(temp_filename);
+    close(fd);
+    TEST_ASSERT_TRUE(write_line_map(temp_filename, "prog.asm"));
+
+    FILE* f = fopen(temp_filename, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char contents[128] = {0};
+    fread(contents, 1, sizeof(contents) - 1, f);
+    TEST_ASSERT_EQUAL_STRING("source prog.asm\n0000 3\n0002 5\n0004 5\n", contents);
+
+    fclose(f);
+    unlink(temp_filename);
+}
+
 int main(void) {
     UNITY_BEGIN(); 
     RUN_TEST(test_basic_emit_and_finalize);
     RUN_TEST(test_symbol_resolution_integration);
+    RUN_TEST(test_reglist_encoding);
+    RUN_TEST(test_line_map);
     
     return UNITY_END();
 }
\ No newline at end of file
@@ -251,14 +251,64 @@ void test_disassemble_stb_instruction(void) {
     TEST_ASSERT_EQUAL_STRING("STB  r1, [r2+4]\n", result);
 }
 
+void test_disassemble_mul_div_instructions(void) {
+    // MUL r1, r2, r3 - opcode=30, func=00
+    uint16_t word = (30 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | 0;
+    TEST_ASSERT_EQUAL_STRING("MUL  r1, r2, r3\n", disassemble_word(word));
+    word = (30 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | 1;
+    TEST_ASSERT_EQUAL_STRING("MULH r1, r2, r3\n", disassemble_word(word));
+    word = (30 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | 2;
+    TEST_ASSERT_EQUAL_STRING("DIV  r1, r2, r3\n", disassemble_word(word));
+    word = (30 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | 3;
+    TEST_ASSERT_EQUAL_STRING("MOD  r1, r2, r3\n", disassemble_word(word));
+}
+
+void test_disassemble_adc_sbc_instructions(void) {
+    // ADC r4, r5, r6 - opcode=31, func=00
+    uint16_t word = (31 << 11) | (4 << 8) | (5 << 5) | (6 << 2) | 0;
+    TEST_ASSERT_EQUAL_STRING("ADC  r4, r5, r6\n", disassemble_word(word));
+    word = (31 << 11) | (4 << 8) | (5 << 5) | (6 << 2) | 1;
+    TEST_ASSERT_EQUAL_STRING("SBC  r4, r5, r6\n", disassemble_word(word));
+}
+
+void test_disassemble_post_increment_instructions(void) {
+    // LDB r1, [r2]+ - opcode=31, func=10, rs2=000
+    uint16_t word = (31 << 11) | (1 << 8) | (2 << 5) | (0 << 2) | 2;
+    TEST_ASSERT_EQUAL_STRING("LDB  r1, [r2]+\n", disassemble_word(word));
+    word = (31 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | 2;
+    TEST_ASSERT_EQUAL_STRING("STW  r1, [r2]+\n", disassemble_word(word));
+}
+
+void test_disassemble_pushm_popm_instructions(void) {
+    // PUSHM r1, r3, ra - opcode=31, func=11, list bits 0, 2 and 5
+    uint16_t word = (31 << 11) | (0b100101 << 2) | 3;
+    TEST_ASSERT_EQUAL_STRING("PUSHM r1, r3, r7\n", disassemble_word(word));
+    word = (31 << 11) | (1 << 10) | (0b100101 << 2) | 3;
+    TEST_ASSERT_EQUAL_STRING("POPM r1, r3, r7\n", disassemble_word(word));
+}
+
 // Test fallback case
 void test_disassemble_unknown_instruction(void) {
-    // Invalid opcode (31) - should fallback to .word
-    uint16_t word = (31 << 11) | 0x123;
-    char* result = disassemble_word(word);
+    // SHR/SRA group (opcode 6) with the unassigned func 10 and 11 - should fallback to .word
+    char expected[32];
+    for (uint16_t func = 2; func <= 3; func++) {
+        uint16_t word = (6 << 11) | (1 << 8) | (2 << 5) | (3 << 2) | func;
+        sprintf(expected, ".word 0x%04X\n", word);
+        TEST_ASSERT_EQUAL_STRING(expected, disassemble_word(word));
+    }
+
+    // MOV/CMP/NOT group (opcode 7) with the unassigned func 11
+    uint16_t word = (7 << 11) | (1 << 8) | (2 << 5) | 3;
+    sprintf(expected, ".word 0x%04X\n", word);
+    TEST_ASSERT_EQUAL_STRING(expected, disassemble_word(word));
+}
+
+void test_disassemble_pushm_reserved_bits(void) {
+    // PUSHM with the must-be-zero bits 9-8 set - should fallback to .word
+    uint16_t word = (31 << 11) | (1 << 8) | (0b001000 << 2) | 3;
     char expected[32];
     sprintf(expected, ".word 0x%04X\n", word);
-    TEST_ASSERT_EQUAL_STRING(expected, result);
+    TEST_ASSERT_EQUAL_STRING(expected, disassemble_word(word));
 }
 
 // Test read_word function
@@ -324,9 +374,14 @@ int main(void) {
     RUN_TEST(test_disassemble_dec_instruction);
     RUN_TEST(test_disassemble_ldb_instruction);
     RUN_TEST(test_disassemble_stb_instruction);
+    RUN_TEST(test_disassemble_mul_div_instructions);
+    RUN_TEST(test_disassemble_adc_sbc_instructions);
+    RUN_TEST(test_disassemble_post_increment_instructions);
+    RUN_TEST(test_disassemble_pushm_popm_instructions);
     
     // Edge cases
     RUN_TEST(test_disassemble_unknown_instruction);
+    RUN_TEST(test_disassemble_pushm_reserved_bits);
     RUN_TEST(test_read_word_little_endian);
     RUN_TEST(test_read_word_edge_cases);
     
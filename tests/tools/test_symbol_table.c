@@ -1,6 +1,7 @@
 #include "../unity/unity.h"
 #include "idn16/symbol_table.h"
 #include <string.h>
+#include <stdio.h>
 
 void setUp(void) {
     // Reset symbol table before each test
@@ -146,6 +147,25 @@ void test_special_characters_in_names(void) {
     TEST_ASSERT_EQUAL_INT(0x2000, value2);
 }
 
+void test_write_symbol_file(void) {
+    insert_symbol("main", 0x0010, 0);
+    insert_symbol("start", 0x0000, 0);
+    insert_symbol("CONSTANT", 0x1234, 1);
+    sort_symbols();
+
+    const char* path = "test_symbols.sym";
+    TEST_ASSERT_TRUE(write_symbol_file(path));
+
+    // Labels only, in address order
+    FILE* f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    char contents[128] = {0};
+    fread(contents, 1, sizeof(contents) - 1, f);
+    fclose(f);
+    remove(path);
+    TEST_ASSERT_EQUAL_STRING("0000 start\n0010 main\n", contents);
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_insert_single_symbol);
@@ -157,5 +177,6 @@ int main(void) {
     RUN_TEST(test_case_sensitive_symbols);
     RUN_TEST(test_zero_value_symbol);
     RUN_TEST(test_special_characters_in_names);
+    RUN_TEST(test_write_symbol_file);
     return UNITY_END();
 }
\ No newline at end of file